@@ -0,0 +1,207 @@
+#include "../include/Model/Board.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+// Compares the bitboard Board against the original vector-of-vectors
+// implementation on the same synthetic positions.
+
+namespace {
+
+// The pre-bitboard Board, kept verbatim as the baseline
+class VectorBoard {
+public:
+    static const int WIDTH = Board::WIDTH;
+    static const int HEIGHT = Board::HEIGHT;
+
+    VectorBoard() : grid(HEIGHT, std::vector<int>(WIDTH, 0)) {}
+
+    bool canPlace(const Tetromino& tetromino, int x, int y) const {
+        const auto& shape = tetromino.getShape();
+
+        for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+            for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+                if (shape[row][col] != 0) {
+                    int boardX = x + col;
+                    int boardY = y + row;
+
+                    if (boardX < 0 || boardX >= WIDTH || boardY >= HEIGHT) {
+                        return false;
+                    }
+                    if (boardY < 0) {
+                        continue;
+                    }
+                    if (grid[boardY][boardX] != 0) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void place(const Tetromino& tetromino, int x, int y) {
+        const auto& shape = tetromino.getShape();
+        int typeValue = static_cast<int>(tetromino.getType()) + 1;
+
+        for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+            for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+                if (shape[row][col] != 0) {
+                    int boardX = x + col;
+                    int boardY = y + row;
+                    if (boardY >= 0 && boardY < HEIGHT && boardX >= 0 && boardX < WIDTH) {
+                        grid[boardY][boardX] = typeValue;
+                    }
+                }
+            }
+        }
+    }
+
+    int clearLines() {
+        int linesCleared = 0;
+        for (int row = HEIGHT - 1; row >= 0; --row) {
+            if (isRowFull(row)) {
+                for (int col = 0; col < WIDTH; ++col) grid[row][col] = 0;
+                for (int r = row; r > 0; --r) {
+                    for (int col = 0; col < WIDTH; ++col) grid[r][col] = grid[r - 1][col];
+                }
+                for (int col = 0; col < WIDTH; ++col) grid[0][col] = 0;
+                ++linesCleared;
+                ++row;
+            }
+        }
+        return linesCleared;
+    }
+
+    bool isRowFull(int row) const {
+        for (int col = 0; col < WIDTH; ++col) {
+            if (grid[row][col] == 0) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::vector<int>> grid;
+};
+
+struct Probe {
+    Tetromino piece;
+    int x;
+    int y;
+};
+
+template <typename BoardT>
+void fillRandom(BoardT& board, unsigned seed) {
+    // Drops the same pseudo-random pieces into either implementation until
+    // the stack reaches half the board height
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> typeDist(0, 6);
+    std::uniform_int_distribution<int> rotDist(0, 3);
+    std::uniform_int_distribution<int> xDist(-2, Board::WIDTH - 2);
+    for (int i = 0; i < 200; ++i) {
+        Tetromino piece(static_cast<TetrominoType>(typeDist(rng)));
+        for (int r = rotDist(rng); r > 0; --r) piece.rotate();
+        int x = xDist(rng);
+        if (!board.canPlace(piece, x, 0)) continue;
+        int y = 0;
+        while (board.canPlace(piece, x, y + 1)) ++y;
+        if (y < Board::HEIGHT / 2) break;
+        board.place(piece, x, y);
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+template <typename BoardT>
+double timeCanPlace(const BoardT& board, const std::vector<Probe>& probes, int rounds, long long& hits) {
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& p : probes) {
+            hits += board.canPlace(p.piece, p.x, p.y) ? 1 : 0;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / (static_cast<double>(rounds) * probes.size());
+}
+
+template <typename BoardT>
+double timeStackAndClear(int games, int& linesOut) {
+    // Two flat I pieces per row plus an O in the last two columns: every
+    // fifth drop completes two rows and triggers a clear
+    const Tetromino flatI(TetrominoType::I);
+    const Tetromino square(TetrominoType::O);
+    const Tetromino* cycle[] = {&flatI, &flatI, &flatI, &flatI, &square};
+    const int cycleX[] = {0, 4, 0, 4, Board::WIDTH - 3};
+
+    long long ops = 0;
+    int lines = 0;
+    auto start = Clock::now();
+    for (int g = 0; g < games; ++g) {
+        BoardT board;
+        for (int step = 0; step < 200; ++step) {
+            const Tetromino& piece = *cycle[step % 5];
+            int x = cycleX[step % 5];
+            int y = -1;
+            while (board.canPlace(piece, x, y + 1)) ++y;
+            if (y < 0) break;
+            board.place(piece, x, y);
+            lines += board.clearLines();
+            ++ops;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    linesOut = lines;
+    return elapsed / static_cast<double>(ops);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(12345);
+
+    VectorBoard vectorBoard;
+    Board bitBoard;
+    fillRandom(vectorBoard, 777);
+    fillRandom(bitBoard, 777);
+
+    std::vector<Probe> probes;
+    std::uniform_int_distribution<int> typeDist(0, 6);
+    std::uniform_int_distribution<int> rotDist(0, 3);
+    std::uniform_int_distribution<int> xDist(-3, Board::WIDTH);
+    std::uniform_int_distribution<int> yDist(-2, Board::HEIGHT);
+    for (int i = 0; i < 4096; ++i) {
+        Tetromino piece(static_cast<TetrominoType>(typeDist(rng)));
+        for (int r = rotDist(rng); r > 0; --r) piece.rotate();
+        probes.push_back({piece, xDist(rng), yDist(rng)});
+    }
+
+    long long vectorHits = 0;
+    long long bitHits = 0;
+    const int rounds = 500;
+    double vectorNs = timeCanPlace(vectorBoard, probes, rounds, vectorHits);
+    double bitNs = timeCanPlace(bitBoard, probes, rounds, bitHits);
+
+    int vectorLines = 0;
+    int bitLines = 0;
+    double vectorStackNs = timeStackAndClear<VectorBoard>(20000, vectorLines);
+    double bitStackNs = timeStackAndClear<Board>(20000, bitLines);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "canPlace        vector: " << std::setw(8) << vectorNs << " ns/op"
+              << "   bitboard: " << std::setw(8) << bitNs << " ns/op"
+              << "   speedup: " << (vectorNs / bitNs) << "x\n";
+    std::cout << "place+clear     vector: " << std::setw(8) << vectorStackNs << " ns/op"
+              << "   bitboard: " << std::setw(8) << bitStackNs << " ns/op"
+              << "   speedup: " << (vectorStackNs / bitStackNs) << "x\n";
+
+    if (vectorHits != bitHits || vectorLines != bitLines) {
+        std::cerr << "Mismatch between implementations: canPlace hits "
+                  << vectorHits << " vs " << bitHits << ", lines "
+                  << vectorLines << " vs " << bitLines << "\n";
+        return 1;
+    }
+    return 0;
+}
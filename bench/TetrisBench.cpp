@@ -0,0 +1,681 @@
+#include "../include/AI/Evaluator.h"
+#include "../include/AI/MoveGenerator.h"
+#include "../include/AI/PlacementSearch.h"
+#include "../include/Model/Board.h"
+#include "../include/Model/BoardKernels.h"
+#include "../include/Model/Game.h"
+#include "../include/Sim/GamePool.h"
+#include "../include/Sim/Policy.h"
+#include "../include/View/Renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Timing harnesses for the engine's hot paths. Each benchmark runs its
+// operation in samples long enough for the clock to resolve, then reports
+// the mean ns/op over the samples and their spread. Results can be written
+// as JSON and checked against a JSON baseline from an earlier run.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Results are folded in here so the optimiser cannot drop the work
+volatile uint64_t g_sink = 0;
+
+struct Benchmark {
+    std::string name;
+    const char* description;
+    // Runs the operation `iterations` times and returns a checksum
+    std::function<uint64_t(uint64_t iterations)> run;
+};
+
+struct Result {
+    std::string name;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    int samples = 0;
+    uint64_t opsPerSample = 0;
+};
+
+struct Options {
+    int samples = 10;
+    double sampleMillis = 20.0;
+    std::string filter;
+    std::string jsonPath;
+    std::string comparePath;
+    double threshold = 10.0;   // percent
+};
+
+// Synthetic positions ------------------------------------------------------
+
+const int SPAWN_X = (Board::WIDTH - Tetromino::MATRIX_SIZE) / 2;
+
+Tetromino randomPiece(std::mt19937& rng) {
+    Tetromino piece(static_cast<TetrominoType>(rng() % PIECE_TYPES));
+    for (int turns = static_cast<int>(rng() % PIECE_ROTATIONS); turns > 0; --turns) {
+        piece.rotate();
+    }
+    return piece;
+}
+
+int stackHeight(const Board& board) {
+    int top = Board::HEIGHT;
+    for (int col = 0; col < Board::WIDTH; ++col) {
+        top = std::min(top, board.getColumnTop(col));
+    }
+    return Board::HEIGHT - top;
+}
+
+// Random hard drops, none of which clears a line, until the stack is
+// `height` rows tall
+Board makeStack(std::mt19937& rng, int height) {
+    Board board;
+    for (int attempt = 0; attempt < 1000 && stackHeight(board) < height; ++attempt) {
+        Tetromino piece = randomPiece(rng);
+        int x = static_cast<int>(rng() % (Board::WIDTH + 3)) - 3;
+        if (!board.canPlace(piece, x, 0)) continue;
+        Board next = board;
+        next.place(piece, x, board.getLandingY(piece, x, 0));
+        if (next.clearLines() == 0) {
+            board = next;
+        }
+    }
+    return board;
+}
+
+struct Drop {
+    Tetromino piece;
+    int x;
+    int y;
+};
+
+// A piece that fits at (x, y) somewhere on `board`, for probes that should
+// not bail out on the first row
+Drop findDrop(std::mt19937& rng, const Board& board) {
+    for (;;) {
+        Drop drop{randomPiece(rng), static_cast<int>(rng() % (Board::WIDTH + 3)) - 3, 0};
+        if (board.canPlace(drop.piece, drop.x, 0)) {
+            drop.y = board.getLandingY(drop.piece, drop.x, 0);
+            return drop;
+        }
+    }
+}
+
+// Mid-game positions from the AI playing uniform random pieces. Boards with
+// full rows still on them, caught between place() and clearLines(), go to
+// `clearable`.
+void playPositions(uint64_t seed, int count, std::vector<Game>& games, std::vector<Board>& clearable) {
+    WeightedEvaluator evaluator;
+    PlacementSearch search(evaluator);
+    std::mt19937 rng(static_cast<unsigned>(seed));
+
+    Game game(seed);
+    game.start();
+    Board board;
+    while (static_cast<int>(games.size()) < count || static_cast<int>(clearable.size()) < count) {
+        if (game.getState() != GameState::PLAYING) {
+            game.start();
+            board.clear();
+        }
+        if (static_cast<int>(games.size()) < count && rng() % 4 == 0) {
+            games.push_back(game);
+        }
+
+        // The game follows the search through its normal inputs
+        Placement best;
+        if (search.findBest(game.getBoard(), game.getCurrentTetromino(), game.getCurrentX(),
+                            game.getCurrentY(), best)) {
+            for (int i = 0; i < best.rotations; ++i) {
+                game.applyAction(InputAction::ROTATE_CW);
+            }
+            for (int i = 0; i < Board::WIDTH && game.getCurrentX() != best.x; ++i) {
+                game.applyAction(game.getCurrentX() < best.x ? InputAction::MOVE_RIGHT : InputAction::MOVE_LEFT);
+            }
+        }
+        game.applyAction(InputAction::HARD_DROP);
+
+        // A bare board replays the same search to catch pre-clear states
+        Tetromino piece = randomPiece(rng);
+        if (!board.canPlace(piece, SPAWN_X, 0) ||
+            !search.findBest(board, piece, SPAWN_X, 0, best)) {
+            board.clear();
+            continue;
+        }
+        for (int i = 0; i < best.rotations; ++i) piece.rotate();
+        board.place(piece, best.x, best.y);
+        bool hasFull = false;
+        for (int row = 0; row < Board::HEIGHT; ++row) {
+            hasFull = hasFull || board.isRowFull(row);
+        }
+        if (hasFull && static_cast<int>(clearable.size()) < count) {
+            clearable.push_back(board);
+        }
+        board.clearLines();
+        if (board.isGameOver()) {
+            board.clear();
+        }
+    }
+}
+
+// Harness ------------------------------------------------------------------
+
+Result measure(const Benchmark& benchmark, const Options& options) {
+    // Double the batch until one takes a measurable share of a sample
+    uint64_t iterations = 1;
+    for (;;) {
+        auto start = Clock::now();
+        g_sink = g_sink + benchmark.run(iterations);
+        double millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (millis >= options.sampleMillis / 4 || iterations >= (1ULL << 40)) {
+            if (millis > 0.0) {
+                iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * options.sampleMillis / millis));
+            }
+            break;
+        }
+        iterations *= 2;
+    }
+
+    std::vector<double> perOp;
+    for (int sample = 0; sample < options.samples; ++sample) {
+        auto start = Clock::now();
+        g_sink = g_sink + benchmark.run(iterations);
+        double nanos = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        perOp.push_back(nanos / static_cast<double>(iterations));
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.samples = options.samples;
+    result.opsPerSample = iterations;
+    double sum = 0.0;
+    for (double ns : perOp) sum += ns;
+    result.meanNs = sum / perOp.size();
+    double squares = 0.0;
+    for (double ns : perOp) squares += (ns - result.meanNs) * (ns - result.meanNs);
+    result.stddevNs = perOp.size() > 1 ? std::sqrt(squares / (perOp.size() - 1)) : 0.0;
+    result.minNs = *std::min_element(perOp.begin(), perOp.end());
+    result.maxNs = *std::max_element(perOp.begin(), perOp.end());
+    return result;
+}
+
+bool writeJson(const std::string& path, const std::vector<Result>& results, std::string& error) {
+    std::ofstream out(path);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    // One benchmark per line keeps the file diffable and easy to read back
+    out << std::setprecision(6) << "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"mean\": " << r.meanNs
+            << ", \"stddev\": " << r.stddevNs << ", \"min\": " << r.minNs
+            << ", \"max\": " << r.maxNs << ", \"samples\": " << r.samples
+            << ", \"ops_per_sample\": " << r.opsPerSample << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+// Reads back what writeJson produced: the name and mean of every line that
+// describes a benchmark
+bool readJson(const std::string& path, std::vector<Result>& results, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t mean = line.find("\"mean\": ");
+        if (name == std::string::npos || mean == std::string::npos) {
+            continue;
+        }
+        name += 9;
+        size_t nameEnd = line.find('"', name);
+        if (nameEnd == std::string::npos) {
+            error = path + " is malformed";
+            return false;
+        }
+        Result result;
+        result.name = line.substr(name, nameEnd - name);
+        result.meanNs = std::strtod(line.c_str() + mean + 8, nullptr);
+        size_t stddev = line.find("\"stddev\": ");
+        if (stddev != std::string::npos) {
+            result.stddevNs = std::strtod(line.c_str() + stddev + 10, nullptr);
+        }
+        results.push_back(result);
+    }
+    if (results.empty()) {
+        error = path + " holds no benchmarks";
+        return false;
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --samples N      timed samples per benchmark (default 10)\n"
+              << "  --sample-ms N    target length of one sample (default 20)\n"
+              << "  --filter TEXT    only run benchmarks whose name contains TEXT\n"
+              << "  --json FILE      write the results as JSON\n"
+              << "  --compare FILE   check the results against a JSON baseline\n"
+              << "  --threshold PCT  slowdown that counts as a regression (default 10)\n"
+              << "  --list           list the benchmarks and exit\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--samples") == 0 && hasValue) {
+            options.samples = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--sample-ms") == 0 && hasValue) {
+            options.sampleMillis = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--compare") == 0 && hasValue) {
+            options.comparePath = argv[++i];
+        } else if (std::strcmp(arg, "--threshold") == 0 && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--list") == 0) {
+            list = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.samples < 2 || options.sampleMillis <= 0.0 || options.threshold <= 0.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Fixed seeds: every run times the same positions
+    std::mt19937 rng(20240601);
+
+    std::vector<Board> stacks;
+    for (int i = 0; i < 256; ++i) {
+        stacks.push_back(makeStack(rng, 2 + i % 12));
+    }
+
+    struct Probe {
+        const Board* board;
+        Drop drop;
+    };
+    std::vector<Probe> probes;
+    for (int i = 0; i < 4096; ++i) {
+        const Board& board = stacks[i % stacks.size()];
+        Drop drop = findDrop(rng, board);
+        // Half the probes at the landing row, half anywhere in the column
+        if (i % 2) drop.y = static_cast<int>(rng() % (drop.y + 2));
+        probes.push_back({&board, drop});
+    }
+
+    std::vector<Drop> scratchDrops;
+    for (int i = 0; i < 64; ++i) {
+        scratchDrops.push_back(findDrop(rng, stacks[255]));
+    }
+
+    std::vector<Game> positions;
+    std::vector<Board> clearable;
+    playPositions(7, 256, positions, clearable);
+
+    Renderer renderer(-1);
+    WeightedEvaluator evaluator;
+    PlacementSearch search(evaluator);
+    MoveGenerator moves;
+    std::unique_ptr<Policy> randomPolicy = Policy::create("random");
+
+    // A batch of live games driven by the same random inputs, once as Game
+    // objects and once in a GamePool; finished games start again
+    const size_t LIVE_GAMES = 4096;
+    const InputAction INPUTS[] = {
+        InputAction::MOVE_LEFT, InputAction::MOVE_RIGHT, InputAction::MOVE_DOWN,
+        InputAction::HARD_DROP, InputAction::ROTATE_CW, InputAction::ROTATE_CCW
+    };
+    std::vector<InputAction> liveInputs(LIVE_GAMES * 8);
+    for (auto& input : liveInputs) {
+        input = INPUTS[rng() % 6];
+    }
+    std::vector<Game> liveGames;
+    GamePool livePool(LIVE_GAMES);
+    for (size_t i = 0; i < LIVE_GAMES; ++i) {
+        liveGames.emplace_back(i + 1);
+        liveGames.back().start();
+        livePool.seed(i, i + 1);
+        livePool.applyAction(i, InputAction::START);
+    }
+    uint64_t gameSteps = 0;
+    uint64_t poolPasses = 0;
+
+    std::vector<Benchmark> benchmarks = {
+        {"board.copy", "copy a Board (baseline for the place and clear rows)",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 Board scratch = stacks[i & 255];
+                 sum += scratch.getRow(Board::HEIGHT - 1);
+             }
+             return sum;
+         }},
+        {"board.canPlace", "collision probe on stacks 2-13 rows tall",
+         [&](uint64_t n) {
+             uint64_t hits = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Probe& p = probes[i & 4095];
+                 hits += p.board->canPlace(p.drop.piece, p.drop.x, p.drop.y + 1);
+             }
+             return hits;
+         }},
+        {"board.landing", "Board::getLandingY from the spawn row",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Probe& p = probes[i & 4095];
+                 sum += static_cast<uint64_t>(p.board->getLandingY(p.drop.piece, p.drop.x, 0));
+             }
+             return sum;
+         }},
+        {"board.place", "copy a stack and lock a piece on it",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Probe& p = probes[i & 4095];
+                 Board scratch = *p.board;
+                 scratch.place(p.drop.piece, p.drop.x, p.board->getLandingY(p.drop.piece, p.drop.x, 0));
+                 sum += scratch.getHash();
+             }
+             return sum;
+         }},
+        {"board.clearLines", "copy a board with full rows and clear them",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 Board scratch = clearable[i % clearable.size()];
+                 sum += static_cast<uint64_t>(scratch.clearLines());
+             }
+             return sum;
+         }},
+        {"board.placeUndo", "placeAndClear followed by undo",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             Board scratch = stacks[255];
+             Board::Undo undo;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Drop& drop = scratchDrops[i & 63];
+                 sum += static_cast<uint64_t>(scratch.placeAndClear(drop.piece, drop.x, drop.y, undo));
+                 scratch.undo(undo);
+             }
+             return sum + scratch.getHash();
+         }},
+        {"game.rotate", "Game::rotate with wall kicks, alternating directions",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             Game game = positions[0];
+             for (uint64_t i = 0; i < n; ++i) {
+                 if ((i & 63) == 0) {
+                     game = positions[(i >> 6) % positions.size()];
+                     // Against a wall every other time so the kicks run
+                     InputAction side = (i & 64) ? InputAction::MOVE_LEFT : InputAction::MOVE_RIGHT;
+                     for (int step = 0; step < Board::WIDTH; ++step) game.applyAction(side);
+                 }
+                 if (i & 1) game.rotateCounterClockwise();
+                 else game.rotate();
+                 sum += static_cast<uint64_t>(game.getCurrentX());
+             }
+             return sum;
+         }},
+        {"game.ghost", "Game::getGhostY on mid-game positions",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 sum += static_cast<uint64_t>(positions[i & 255].getGhostY());
+             }
+             return sum;
+         }},
+        {"render.frame", "Renderer::render of changing positions into a null sink",
+         [&](uint64_t n) {
+             for (uint64_t i = 0; i < n; ++i) {
+                 renderer.render(positions[i & 255]);
+             }
+             return renderer.getSink().getTotalBytes();
+         }},
+        {"ai.findBest", "hard-drop placement search",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             Placement best;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Game& game = positions[i & 255];
+                 search.findBest(game.getBoard(), game.getCurrentTetromino(), game.getCurrentX(), game.getCurrentY(), best);
+                 sum += static_cast<uint64_t>(best.x);
+             }
+             return sum;
+         }},
+        {"ai.moveGenerator", "BFS over every reachable lock position",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 const Game& game = positions[i & 255];
+                 sum += static_cast<uint64_t>(moves.generate(game.getBoard(), game.getCurrentTetromino(),
+                                                             game.getCurrentX(), game.getCurrentY()));
+             }
+             return sum;
+         }},
+        {"game.randomGame", "a whole game of random inputs, 16 ticks apart",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i) {
+                 Game game(i + 1);
+                 game.start();
+                 randomPolicy->reset(i + 1);
+                 while (game.getState() == GameState::PLAYING) {
+                     game.step(randomPolicy->chooseAction(game), 16);
+                 }
+                 sum += static_cast<uint64_t>(game.getScore());
+             }
+             return sum;
+         }},
+        {"game.step", "one input and 16 ticks for each of 4096 live Games in turn",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < n; ++i, ++gameSteps) {
+                 Game& game = liveGames[gameSteps % LIVE_GAMES];
+                 if (game.getState() == GameState::GAME_OVER) {
+                     game.start();
+                 }
+                 game.step(liveInputs[gameSteps % liveInputs.size()], 16);
+                 sum += static_cast<uint64_t>(game.getScore());
+             }
+             return sum;
+         }},
+        {"pool.step", "the same through GamePool::stepAll, per game",
+         [&](uint64_t n) {
+             uint64_t sum = 0;
+             for (uint64_t done = 0; done < n; done += LIVE_GAMES, ++poolPasses) {
+                 const InputAction* inputs = &liveInputs[(poolPasses % 8) * LIVE_GAMES];
+                 if (n - done < LIVE_GAMES) {
+                     for (size_t i = 0; i < n - done; ++i) {
+                         livePool.step(i, inputs[i], 16);
+                     }
+                     break;
+                 }
+                 livePool.restartFinished();
+                 livePool.stepAll(inputs, 16);
+                 sum += static_cast<uint64_t>(livePool.getScore(poolPasses % LIVE_GAMES));
+             }
+             return sum;
+         }},
+    };
+
+    // Every rotation and column of every piece on each stack, as the batch
+    // kernels take them: at the spawn row for landings, and for collisions
+    // also one to two rows past where each lands
+    struct CandidateSet {
+        const Board* board;
+        std::vector<PlacementProbe> drops;
+        std::vector<PlacementProbe> probes;
+    };
+    std::vector<CandidateSet> candidateSets;
+    for (const Board& board : stacks) {
+        CandidateSet set{&board, {}, {}};
+        for (int type = 0; type < PIECE_TYPES; ++type) {
+            Tetromino piece(static_cast<TetrominoType>(type));
+            for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation, piece.rotate()) {
+                for (int x = -Tetromino::MATRIX_SIZE + 1; x < Board::WIDTH; ++x) {
+                    if (!board.canPlace(piece, x, 0)) continue;
+                    int landing = board.getLandingY(piece, x, 0);
+                    set.drops.push_back({piece, static_cast<int8_t>(x), 0});
+                    set.probes.push_back({piece, static_cast<int8_t>(x), static_cast<int8_t>(landing + 1 + rng() % 2)});
+                    set.probes.push_back({piece, static_cast<int8_t>(x), static_cast<int8_t>(rng() % (landing + 1))});
+                }
+            }
+        }
+        candidateSets.push_back(std::move(set));
+    }
+    std::vector<Board> rowBoards(stacks);
+    rowBoards.insert(rowBoards.end(), clearable.begin(), clearable.end());
+    std::vector<uint8_t> kernelFits(512);
+    std::vector<int8_t> kernelLandings(512);
+    std::vector<uint32_t> kernelRows(rowBoards.size());
+    uint64_t kernelBatch = 0;
+
+    // The kernels at every instruction set this CPU runs; per op is one
+    // placement or one board
+    for (int level = 0; level <= static_cast<int>(BoardKernels::getBestIsa()); ++level) {
+        const BoardKernels kernels(static_cast<BoardKernels::Isa>(level));
+        const std::string isa = BoardKernels::getIsaName(kernels.getIsa());
+        benchmarks.push_back({"simd.fit." + isa, "BoardKernels::canPlace over every candidate on a stack",
+            [&, kernels](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t done = 0; done < n;) {
+                    const CandidateSet& set = candidateSets[kernelBatch++ & 255];
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(set.probes.size(), n - done));
+                    kernels.canPlace(*set.board, set.probes.data(), count, kernelFits.data());
+                    sum += kernelFits[count / 2];
+                    done += count;
+                }
+                return sum;
+            }});
+        benchmarks.push_back({"simd.land." + isa, "BoardKernels::getLandingY from the spawn row",
+            [&, kernels](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t done = 0; done < n;) {
+                    const CandidateSet& set = candidateSets[kernelBatch++ & 255];
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(set.drops.size(), n - done));
+                    kernels.getLandingY(*set.board, set.drops.data(), count, kernelLandings.data());
+                    sum += static_cast<uint64_t>(kernelLandings[count / 2]);
+                    done += count;
+                }
+                return sum;
+            }});
+        benchmarks.push_back({"simd.fullRows." + isa, "BoardKernels::getFullRows over stacks and boards with full rows",
+            [&, kernels](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t done = 0; done < n;) {
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(rowBoards.size(), n - done));
+                    kernels.getFullRows(rowBoards.data(), count, kernelRows.data());
+                    sum += kernelRows[count / 2];
+                    done += count;
+                }
+                return sum;
+            }});
+    }
+
+    if (list) {
+        for (const auto& benchmark : benchmarks) {
+            std::cout << std::left << std::setw(20) << benchmark.name << benchmark.description << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<Result> baseline;
+    if (!options.comparePath.empty()) {
+        std::string error;
+        if (!readJson(options.comparePath, baseline, error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(20) << "benchmark" << std::right
+              << std::setw(14) << "ns/op" << std::setw(10) << "+/-" << std::setw(8) << "cv"
+              << std::setw(14) << "min" << std::setw(14) << "ops/s";
+    if (!baseline.empty()) {
+        std::cout << std::setw(14) << "baseline" << std::setw(10) << "change";
+    }
+    std::cout << "\n";
+
+    for (const auto& benchmark : benchmarks) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        Result result = measure(benchmark, options);
+        results.push_back(result);
+
+        double cv = result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0;
+        std::cout << std::left << std::setw(20) << result.name << std::right
+                  << std::setw(14) << result.meanNs << std::setw(10) << result.stddevNs
+                  << std::setw(7) << cv << "%" << std::setw(14) << result.minNs
+                  << std::setw(14) << 1e9 / result.meanNs;
+
+        for (const Result& base : baseline) {
+            if (base.name != result.name || base.meanNs <= 0.0) {
+                continue;
+            }
+            double change = 100.0 * (result.meanNs - base.meanNs) / base.meanNs;
+            // Slower by more than the threshold and by more than the noise
+            // of both runs combined
+            bool regressed = change > options.threshold &&
+                             result.meanNs - base.meanNs > 2.0 * (result.stddevNs + base.stddevNs);
+            std::cout << std::setw(14) << base.meanNs << std::setw(9) << std::showpos << change
+                      << std::noshowpos << "%" << (regressed ? "  REGRESSION" : "");
+            regressions += regressed ? 1 : 0;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::string error;
+        if (!writeJson(options.jsonPath, results, error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    }
+
+    if (regressions > 0) {
+        std::cerr << regressions << " benchmark(s) regressed by more than " << options.threshold << "%\n";
+        return 2;
+    }
+    return 0;
+}
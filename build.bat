@@ -5,10 +5,24 @@ if not exist "build" mkdir build
 
 g++ -std=c++17 -Wall -Wextra ^
     src/main.cpp ^
+    src/Model/Random.cpp ^
     src/Model/Tetromino.cpp ^
+    src/Model/PieceGenerator.cpp ^
     src/Model/Board.cpp ^
     src/Model/Game.cpp ^
+    src/Model/Replay.cpp ^
+    src/Model/MappedFile.cpp ^
+    src/Model/ReplayArchive.cpp ^
+    src/AI/Evaluator.cpp ^
+    src/AI/MoveGenerator.cpp ^
+    src/AI/TranspositionTable.cpp ^
+    src/AI/PlacementSearch.cpp ^
+    src/AI/AutoPlayer.cpp ^
+    src/View/FrameBuffer.cpp ^
+    src/View/FrameStats.cpp ^
     src/View/Renderer.cpp ^
+    src/View/TerminalSink.cpp ^
+    src/Controller/KeyDecoder.cpp ^
     src/Controller/InputHandler.cpp ^
     src/Controller/GameController.cpp ^
     -I include ^
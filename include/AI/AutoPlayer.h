@@ -0,0 +1,47 @@
+#ifndef AUTO_PLAYER_H
+#define AUTO_PLAYER_H
+
+#include "../Model/Game.h"
+#include "PlacementSearch.h"
+
+// Plays a Game one input at a time: when a new piece appears it searches
+// for the best placement, then rotates, steers and hard-drops towards it.
+// In REACHABLE mode it follows the shortest input path instead, and plans
+// again from wherever the piece is if gravity knocks it off that path.
+class AutoPlayer {
+public:
+    enum class SearchMode {
+        HARD_DROP,   // rotate, shift, hard drop
+        REACHABLE    // every lock position, tucks and spins included
+    };
+
+    explicit AutoPlayer(const Evaluator& evaluator, SearchMode mode = SearchMode::HARD_DROP);
+
+    // Forget the current plan, e.g. before a new game
+    void reset();
+    // Shared cache for the hard-drop search; see PlacementSearch
+    void setTranspositionTable(TranspositionTable* table);
+    // NONE when there is nothing to do (the game is not being played)
+    InputAction chooseAction(const Game& game);
+
+    // Placement searches run and candidates scored so far
+    long long getSearchCount() const;
+    long long getCandidateCount() const;
+
+private:
+    PlacementSearch search;
+    SearchMode mode;
+    long long plannedPiece;
+    int rotationsLeft;
+    int targetX;
+    int lastX;
+    InputPath path;
+    int pathStep;
+
+    long long searchCount;
+    long long candidateCount;
+
+    InputAction followPath(const Game& game);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "../Model/Board.h"
+#include <array>
+
+// Shape of the stack after a placement, with full rows already removed
+struct BoardFeatures {
+    int aggregateHeight = 0;   // sum of column heights
+    int maxHeight = 0;
+    int holes = 0;             // empty cells with a filled cell above them
+    int bumpiness = 0;         // sum of height differences between neighbours
+    int linesCleared = 0;
+    bool toppedOut = false;    // blocks left in the spawn rows
+
+    using Rows = std::array<Board::Row, Board::HEIGHT>;
+
+    // Works on occupancy words alone, so no Board copy is needed
+    static BoardFeatures measure(const Rows& rows, int linesCleared);
+};
+
+// Scores a position; higher is better. The placement search calls it once
+// per candidate, so implementations should be cheap and allocation-free.
+class Evaluator {
+public:
+    virtual ~Evaluator() = default;
+    virtual double evaluate(const BoardFeatures& features) const = 0;
+};
+
+// Linear combination of the features
+class WeightedEvaluator : public Evaluator {
+public:
+    struct Weights {
+        double aggregateHeight;
+        double linesCleared;
+        double holes;
+        double bumpiness;
+    };
+
+    // Weights tuned for line clearing by a genetic search (Yiyuan Lee)
+    static const Weights DEFAULT_WEIGHTS;
+
+    explicit WeightedEvaluator(const Weights& weights = DEFAULT_WEIGHTS);
+
+    double evaluate(const BoardFeatures& features) const override;
+
+private:
+    Weights weights;
+
+    static const double TOP_OUT_PENALTY;
+};
+
+#endif
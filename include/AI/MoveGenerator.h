@@ -0,0 +1,105 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+
+#include "../Model/Board.h"
+#include "../Model/InputAction.h"
+#include "../Model/Tetromino.h"
+#include <array>
+#include <cstdint>
+
+// One input of a path and the piece state it is applied to
+struct PathStep {
+    InputAction action;
+    int8_t x;
+    int8_t y;
+    int8_t rotation;
+};
+
+struct InputPath {
+    static const int MAX_LENGTH = 128;
+
+    std::array<PathStep, MAX_LENGTH> steps;
+    int length = 0;
+};
+
+// A distinct final resting place for the piece. Rotations of symmetric
+// pieces that cover the same cells count once.
+struct LockPosition {
+    Tetromino piece;
+    int x;
+    int y;
+    int pathLength;   // inputs needed, the closing hard drop included
+    int node;         // search node the path is rebuilt from
+};
+
+// Breadth-first search over (x, y, rotation) from the piece's current
+// state, using the moves the engine accepts: left, right, soft drop and
+// both rotations with Game's exact wall kicks. That finds tucks under
+// overhangs and spins at the bottom that hard-drop enumeration misses,
+// along with the shortest input path to each lock position. Gravity is
+// ignored: inputs are assumed to be faster than the drop interval.
+//
+// All state lives in fixed-size arrays inside the generator, so a search
+// makes no allocations; reuse one generator for many searches.
+class MoveGenerator {
+public:
+    MoveGenerator();
+
+    // Returns the number of lock positions found
+    int generate(const Board& board, const Tetromino& piece, int x, int y);
+
+    int getCount() const;
+    const LockPosition& get(int index) const;
+    // The inputs from the start state to lock position `index`, ending
+    // with HARD_DROP
+    void getPath(int index, InputPath& path) const;
+
+    int getStatesVisited() const;
+
+private:
+    // x ranges over [-3, WIDTH) and is stored offset by X_OFFSET
+    static const int X_OFFSET = Tetromino::MATRIX_SIZE - 1;
+    static const int X_SLOTS = 16;
+    static_assert(Board::WIDTH + X_OFFSET <= X_SLOTS, "x slots must cover the playfield");
+    static const int MAX_NODES = Board::HEIGHT * PIECE_ROTATIONS * X_SLOTS;
+
+    struct Node {
+        int8_t x;
+        int8_t y;
+        int8_t rotation;
+        InputAction action;   // how this node was reached from its parent
+        int16_t parent;       // -1 for the start state
+        int16_t depth;
+    };
+
+    // One bit per (rotation, x) for every row, for states and for lock
+    // footprints
+    using RowBits = std::array<uint64_t, Board::HEIGHT>;
+
+    std::array<Node, MAX_NODES> nodes;
+    int nodeCount;
+    RowBits visited;
+    RowBits locked;
+
+    std::array<LockPosition, MAX_NODES> locks;
+    int lockCount;
+
+    // Bit y of blocked[bitIndex(rotation, x)] is set when the piece does
+    // not fit at row y. Each entry is built lazily from the board's
+    // occupancy words, after which every probe of the search is a bit test.
+    std::array<Board::Row, Board::HEIGHT> rows;
+    std::array<uint32_t, PIECE_ROTATIONS * X_SLOTS> blocked;
+    uint64_t blockedKnown;
+
+    TetrominoType pieceType;
+    std::array<Tetromino, PIECE_ROTATIONS> rotations;
+
+    bool fits(int rotation, int x, int y);
+    uint32_t computeBlocked(const Tetromino& piece, int x) const;
+    bool rotateWithKicks(int& rotation, int& x, int y, bool clockwise);
+    bool visit(int rotation, int x, int y, InputAction action, int parent);
+    static int bitIndex(int rotation, int x);
+    static int canonicalRotation(TetrominoType type, int rotation);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef PLACEMENT_SEARCH_H
+#define PLACEMENT_SEARCH_H
+
+#include "../Model/Board.h"
+#include "../Model/Tetromino.h"
+#include "Evaluator.h"
+#include "MoveGenerator.h"
+#include "TranspositionTable.h"
+
+// Where a piece ends up, and how to get it there from where it started:
+// `rotations` clockwise turns, then sideways moves to column x, then a hard
+// drop that lands it on row y. Reachable searches return an InputPath
+// instead, and `rotations` is only the net turn.
+struct Placement {
+    int rotations = 0;
+    int x = 0;
+    int y = 0;
+    int linesCleared = 0;
+    double score = 0.0;
+};
+
+// Enumerates every final placement reachable with Game's own moves
+// (clockwise rotations with wall kicks, sideways moves, hard drop), or
+// with MoveGenerator the full set including soft-drop tucks, and
+// scores each with an Evaluator. Works on copies of the occupancy words
+// only, so a search makes no allocations and never touches a Game.
+class PlacementSearch {
+public:
+    explicit PlacementSearch(const Evaluator& evaluator);
+
+    // findBest() looks positions up in `table` before searching them and
+    // stores what it finds; nullptr (the default) turns that off. The table
+    // may be shared with searches on other threads.
+    void setTranspositionTable(TranspositionTable* table);
+
+    // False if the piece has nowhere to go
+    bool findBest(const Board& board, const Tetromino& piece, int x, int y, Placement& best);
+    // Same over every lock position the MoveGenerator can reach, tucks and
+    // spins included; path receives the inputs that lead there
+    bool findBestReachable(const Board& board, const Tetromino& piece, int x, int y,
+                           Placement& best, InputPath& path);
+
+    // Candidates scored by the last findBest(), 0 after a table hit
+    int getLastCandidateCount() const;
+
+private:
+    const Evaluator& evaluator;
+    MoveGenerator moves;
+    TranspositionTable* table;
+    int lastCandidateCount;
+
+    double scorePlacement(const BoardFeatures::Rows& rows,
+                          const std::array<uint8_t, Tetromino::MATRIX_SIZE>& masks,
+                          int x, int y, int& linesCleared);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "../Model/Board.h"
+#include "../Model/Tetromino.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// A stored search result: the best move from a position and its score,
+// searched `depth` pieces deep
+struct TableEntry {
+    float score = 0.0f;
+    int depth = 0;
+    int rotations = 0;
+    int x = 0;
+    int y = 0;
+    int linesCleared = 0;
+};
+
+struct TableStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    // Probes that found their bucket holding other positions only
+    uint64_t collisions = 0;
+    uint64_t stores = 0;
+    // Stores that evicted a different position
+    uint64_t replacements = 0;
+};
+
+// Fixed-size hash table of search results that any number of threads can
+// probe and store into without locks. Each slot is a pair of 64-bit words,
+// the entry and the key XOR the entry, so a slot torn by concurrent writers
+// fails the key check and reads as a miss instead of returning a mixed-up
+// entry. Buckets hold two slots: one kept for the deepest search seen and
+// one that always takes the newest store.
+//
+// Entries are only meaningful for the evaluator that produced them; share a
+// table between searches using the same weights.
+class TranspositionTable {
+public:
+    // The bucket count is rounded down to a power of two, at least one
+    explicit TranspositionTable(size_t megabytes);
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Position of `piece` at (x, y) over `board`
+    static uint64_t makeKey(const Board& board, const Tetromino& piece, int x, int y);
+
+    bool probe(uint64_t key, TableEntry& entry);
+    void store(uint64_t key, const TableEntry& entry);
+    // Empties the table and zeroes the counters; not safe while other
+    // threads are using it
+    void clear();
+
+    size_t getBucketCount() const;
+    size_t getSizeBytes() const;
+    TableStats getStats() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;   // key ^ data
+        std::atomic<uint64_t> data;    // packed entry, 0 when empty
+    };
+
+    struct alignas(32) Bucket {
+        Slot deepest;
+        Slot newest;
+    };
+
+    // Each counter on its own cache line, so threads bumping different
+    // counters do not contend
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t mask;
+
+    Counter probes;
+    Counter hits;
+    Counter collisions;
+    Counter stores;
+    Counter replacements;
+
+    static uint64_t pack(const TableEntry& entry);
+    static TableEntry unpack(uint64_t data);
+    // The slot's data if it holds `key`, otherwise 0
+    static uint64_t read(const Slot& slot, uint64_t key);
+    static bool isOccupied(const Slot& slot);
+    static void write(Slot& slot, uint64_t key, uint64_t data);
+};
+
+#endif
@@ -1,41 +1,110 @@
 #ifndef GAME_CONTROLLER_H
 #define GAME_CONTROLLER_H
 
+#include "../AI/AutoPlayer.h"
 #include "../Model/Game.h"
+#include "../Model/Replay.h"
+#include "../Model/ReplayArchive.h"
 #include "../View/Renderer.h"
 #include "InputHandler.h"
+#include <array>
 #include <chrono>
+#include <memory>
+#include <string>
 
-class GameController {
+// How far past its deadline the loop actually woke up
+struct WakeupStats {
+    uint64_t timerWakeups = 0;
+    uint64_t inputWakeups = 0;
+    std::chrono::microseconds totalLateness{0};
+    std::chrono::microseconds maxLateness{0};
+
+    void record(std::chrono::steady_clock::duration lateness);
+};
+
+// Runs the terminal game on a W x H board. The autoplayer and replays work
+// on the standard board only, so for other sizes enableAutoPlay() and
+// startRecording() do nothing and runReplay() returns at once. Members are
+// defined in GameController.cpp and instantiated there for every size
+// BasicGame is.
+template <int W, int H>
+class BasicGameController {
 public:
-    GameController();
-    ~GameController();
+    static constexpr bool IS_STANDARD = W == Board::WIDTH && H == Board::HEIGHT;
+
+    BasicGameController();
+    ~BasicGameController();
 
     void run();
+    // Plays a recorded session back in real time; q stops it
+    void runReplay(const Replay& replay);
+
+    // Piece generation for the games this controller starts
+    void setPiecePolicy(PiecePolicy policy);
+    void setPreviewDepth(int depth);
+
+    // Let the autoplayer make the moves; the keyboard still pauses and quits
+    void enableAutoPlay();
+
+    // Records every engine input from now on; call before run()
+    void startRecording();
+    bool saveRecording(const std::string& path, std::string& error) const;
+    // The same into a seekable ReplayArchive, snapshotting the game every
+    // keyframeInterval pieces; call before run()
+    void startArchiving(int keyframeInterval = ReplayArchive::DEFAULT_KEYFRAME_INTERVAL);
+    bool saveArchive(const std::string& path, std::string& error) const;
+
+    const WakeupStats& getWakeupStats() const;
+    // Phase timings, frame sizes and key latencies for the whole session;
+    // F shows their percentiles in game
+    const FrameStats& getFrameStats() const;
 
 private:
-    Game game;
+    BasicGame<W, H> game;
     Renderer renderer;
     InputHandler inputHandler;
 
     bool running;
-    std::chrono::steady_clock::time_point lastDropTime;
+    bool needsRender;
+    std::chrono::steady_clock::time_point lastTickTime;
     std::chrono::steady_clock::time_point lastRenderTime;
+    WakeupStats wakeupStats;
+    FrameStats frameStats;
+    bool statsVisible;
+    // Read times of keys handled since the last frame, waiting for it to
+    // be presented; keys beyond the capacity go unmeasured
+    std::array<std::chrono::steady_clock::time_point, 64> pendingKeys;
+    int pendingKeyCount;
+    std::unique_ptr<ReplayRecorder> recorder;
+    std::unique_ptr<ReplayArchiveWriter> archiveWriter;
+    WeightedEvaluator evaluator;
+    std::unique_ptr<AutoPlayer> autoPlayer;
+    std::chrono::steady_clock::time_point nextAutoMoveTime;
 
-    void handleInput();
+    // Returns the number of keys handled
+    int handleInput();
     void update();
     void render();
+    void autoPlay();
+    void applyAction(InputAction action);
+    std::chrono::steady_clock::time_point nextDeadline() const;
 
     void handleMenuInput(InputAction action);
     void handlePlayingInput(InputAction action);
     void handlePausedInput(InputAction action);
     void handleGameOverInput(InputAction action);
 
-    bool shouldDrop();
-    void resetDropTimer();
+    void resetTickClock();
+    void toggleStats();
 
-    static const int TARGET_FPS = 60;
-    static const int FRAME_DURATION_MS = 1000 / TARGET_FPS;
+    static constexpr int TARGET_FPS = 60;
+    static constexpr int FRAME_DURATION_MS = 1000 / TARGET_FPS;
+    static constexpr std::chrono::milliseconds FRAME_DURATION{FRAME_DURATION_MS};
+    // Pace of autoplayer inputs, slow enough to follow
+    static constexpr std::chrono::milliseconds AUTO_MOVE_INTERVAL{40};
 };
 
+// The guideline-sized game
+using GameController = BasicGameController<10, 20>;
+
 #endif
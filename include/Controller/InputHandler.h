@@ -1,30 +1,74 @@
 #ifndef INPUT_HANDLER_H
 #define INPUT_HANDLER_H
 
-enum class InputAction {
-    NONE,
-    MOVE_LEFT,
-    MOVE_RIGHT,
-    MOVE_DOWN,
-    HARD_DROP,
-    ROTATE_CW,
-    ROTATE_CCW,
-    PAUSE,
-    QUIT,
-    START,
-    RESTART
+#include "../Model/InputAction.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <termios.h>
+#endif
+
+struct KeyEvent {
+    InputAction action;
+    std::chrono::steady_clock::time_point timestamp;  // when the key was read
 };
 
+// Puts the console in raw mode once for the whole session and runs a reader
+// thread that turns complete key sequences into timestamped KeyEvents. The
+// game loop drains them without blocking.
 class InputHandler {
 public:
     InputHandler();
+    ~InputHandler();
 
-    InputAction getInput();
+    InputHandler(const InputHandler&) = delete;
+    InputHandler& operator=(const InputHandler&) = delete;
+
+    // Next queued event, if any
+    bool pollEvent(KeyEvent& event);
     bool isKeyPressed();
 
+    // Blocks until an event is queued, input closes, or the deadline
+    // passes; time_point::max() waits indefinitely. Returns true if an
+    // event is ready.
+    bool waitForEvent(std::chrono::steady_clock::time_point deadline);
+    // True once stdin has reached end-of-file or failed
+    bool isClosed() const;
+
+    // Events lost because the game loop fell behind by a full ring
+    uint64_t getDroppedEvents() const;
+
 private:
+    static const size_t EVENT_CAPACITY = 256;
+
+    SpscRing<KeyEvent, EVENT_CAPACITY> events;
+    std::thread reader;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> droppedEvents;
+    std::atomic<bool> closed;
+
+    // Lets the game loop sleep until the reader has something for it; the
+    // events themselves still travel through the lock-free ring
+    std::mutex doorbellMutex;
+    std::condition_variable doorbell;
+
+#ifndef _WIN32
+    struct termios originalTermios;
+    bool termiosSaved;
+    int wakePipe[2];
+#endif
+
     void setupConsole();
     void restoreConsole();
+    void readerLoop();
+    void pushAction(InputAction action, std::chrono::steady_clock::time_point timestamp);
+    void ringDoorbell();
 };
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef KEY_DECODER_H
+#define KEY_DECODER_H
+
+#include "../Model/InputAction.h"
+#include <cstddef>
+
+// Turns raw terminal bytes into InputActions. Ordinary keys map one byte to
+// one action; arrow keys arrive as escape sequences that may be split across
+// reads, so the decoder remembers how far into a sequence it is.
+class KeyDecoder {
+public:
+    KeyDecoder() : state(State::GROUND) {}
+
+    // Decodes `size` bytes, continuing any sequence an earlier call left
+    // open, and calls emit(action) for each mapped key in order
+    template <typename Emit>
+    void feed(const unsigned char* data, size_t size, Emit&& emit);
+
+    // True while an escape sequence is incomplete
+    bool hasPartial() const { return state != State::GROUND; }
+    // Gives up on an incomplete sequence, e.g. a lone ESC whose rest never
+    // came
+    void reset() { state = State::GROUND; }
+
+    static InputAction mapKey(int ch);
+
+private:
+    enum class State {
+        GROUND,
+        ESCAPE,   // after ESC
+        CONTROL   // after ESC [ or ESC O, before the final byte
+    };
+    State state;
+};
+
+template <typename Emit>
+void KeyDecoder::feed(const unsigned char* data, size_t size, Emit&& emit) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char ch = data[i];
+
+        if (state == State::ESCAPE) {
+            if (ch == '[' || ch == 'O') {
+                state = State::CONTROL;
+                continue;
+            }
+            // A lone ESC followed by an ordinary key
+            state = State::GROUND;
+        } else if (state == State::CONTROL) {
+            // Skip parameter and intermediate bytes up to the final byte
+            if (ch >= 0x20 && ch < 0x40) {
+                continue;
+            }
+            state = State::GROUND;
+            switch (ch) {
+                case 'A': emit(InputAction::ROTATE_CW); break;   // Up arrow
+                case 'B': emit(InputAction::MOVE_DOWN); break;   // Down arrow
+                case 'C': emit(InputAction::MOVE_RIGHT); break;  // Right arrow
+                case 'D': emit(InputAction::MOVE_LEFT); break;   // Left arrow
+                default: break;
+            }
+            continue;
+        }
+
+        if (ch == 27) {
+            state = State::ESCAPE;
+            continue;
+        }
+        InputAction action = mapKey(ch);
+        if (action != InputAction::NONE) {
+            emit(action);
+        }
+    }
+}
+
+#endif
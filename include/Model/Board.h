@@ -1,32 +1,128 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include <vector>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 #include "Tetromino.h"
 
-class Board {
+// Bitboard playfield: one occupancy word per row (bit x = column x) for
+// collision and line checks, plus a colour plane that only the renderer reads.
+// A Zobrist hash of the occupancy is kept up to date for transposition
+// tables; it ignores colours, which never affect play.
+// Colour rows are reached through a slot index, so clearing lines moves one
+// byte per surviving row and recycles the cleared rows' storage at the top.
+// A skyline of per-column tops is kept alongside so straight drops (ghost,
+// hard drop, AI landings) resolve without walking the rows.
+//
+// The dimensions are template parameters so each size gets its own row word
+// and a collision check with every bound known at compile time: rows are
+// packed side by side into 64-bit words and tested against the piece in one
+// AND per word, with no branch per row. Members are
+// defined in Board.cpp and instantiated there for the sizes the front end
+// offers: 10x20, 10x40 (guideline buffer zone), 16x20 and 32x20.
+template <int W, int H>
+class BasicBoard {
+    static_assert(W >= Tetromino::MATRIX_SIZE && W <= 32, "rows are at most 32 bits wide");
+    static_assert(H >= Tetromino::MATRIX_SIZE && H <= 64, "column tops and undo rows are 8-bit");
+
+    // A piece can hang up to MATRIX_SIZE - 1 columns past either wall, so
+    // the collision check shifts each row up by that many guard bits and
+    // needs as many spare bits above it
+    static constexpr int GUARD_BITS = Tetromino::MATRIX_SIZE - 1;
+
 public:
-    static const int WIDTH = 10;
-    static const int HEIGHT = 20;
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+
+    // The narrowest word that holds a row and its guard bits: 16 bits for
+    // the standard board, 32 up to 26 columns, 64 beyond
+    using Row = typename std::conditional<W + 2 * GUARD_BITS <= 16, uint16_t,
+                typename std::conditional<W + 2 * GUARD_BITS <= 32, uint32_t, uint64_t>::type>::type;
+    using ColorRow = std::array<uint8_t, WIDTH>;
 
-    Board();
+    static constexpr Row FULL_ROW = static_cast<Row>((1ULL << WIDTH) - 1);
+
+    // What placeAndClear() changed, enough to put the board back exactly.
+    // Only rows the piece covers can fill up, so at most MATRIX_SIZE clear.
+    struct Undo {
+        std::array<Row, Tetromino::MATRIX_SIZE> placedBits;   // per piece row
+        int8_t placedY;
+        int8_t stackTop;                                      // after placing
+        uint8_t clearedCount;
+        std::array<int8_t, Tetromino::MATRIX_SIZE> clearedRows;   // ascending
+        std::array<ColorRow, Tetromino::MATRIX_SIZE> clearedColors;
+        std::array<int8_t, WIDTH> columnTops;
+        uint64_t hash;
+    };
+
+    BasicBoard();
 
     void clear();
+    // Replaces the whole board with the given colour rows, top first; any
+    // non-zero colour is a filled cell. For restoring a saved position.
+    void setCells(const std::array<ColorRow, HEIGHT>& colors);
     bool canPlace(const Tetromino& tetromino, int x, int y) const;
     void place(const Tetromino& tetromino, int x, int y);
     int clearLines();
 
+    // place() and clearLines() in one go, recording the change so undo()
+    // can revert it. The piece must fit at (x, y).
+    int placeAndClear(const Tetromino& tetromino, int x, int y, Undo& undo);
+    void undo(const Undo& undo);
+
+    // Row the piece comes to rest on when dropped straight down from (x, y),
+    // which must be a legal position
+    int getLandingY(const Tetromino& tetromino, int x, int y) const;
+    // Row of the highest filled cell in column x, HEIGHT when it is empty
+    int getColumnTop(int x) const;
+    // Zobrist hash of the occupied cells; equal boards hash equal however
+    // they were reached
+    uint64_t getHash() const;
+
     int getCell(int x, int y) const;
+    Row getRow(int y) const;
     bool isRowFull(int row) const;
     bool isGameOver() const;
 
-    const std::vector<std::vector<int>>& getGrid() const;
+    // Colour values of row y, 0 for empty cells
+    const ColorRow& getColorRow(int y) const;
+
+    // The occupancy words themselves, row y at getRowWords()[y], for
+    // kernels that load several rows at once. The MATRIX_SIZE rows either
+    // side of the board are readable too: empty above, full below.
+    const Row* getRowWords() const { return rows.data() + PAD_ROWS; }
 
 private:
-    std::vector<std::vector<int>> grid;
+    // Row y lives at rows[PAD_ROWS + y]. The rows above the board are
+    // always empty and the rows below it always full, so the collision
+    // check reads any row a piece can cover without testing the bounds.
+    static constexpr int PAD_ROWS = Tetromino::MATRIX_SIZE;
+
+    std::array<Row, PAD_ROWS + HEIGHT + PAD_ROWS> rows;
+    std::array<ColorRow, HEIGHT> colorSlots;
+    std::array<uint8_t, HEIGHT> colorIndex;   // row -> slot in colorSlots
+    std::array<int8_t, WIDTH> columnTops;
+    uint64_t hash;
 
-    void clearRow(int row);
-    void shiftRowsDown(int fromRow);
+    Row& rowAt(int y) { return rows[PAD_ROWS + y]; }
+    Row rowAt(int y) const { return rows[PAD_ROWS + y]; }
+
+    void rebuildColumnTops();
+    // The keys of the cells filled in `row`
+    uint64_t rowHash(int row) const;
+    // Columns covered by a piece row with matrix mask `mask` at column x
+    static Row pieceRowBits(uint8_t mask, int x);
+
+    static constexpr int ROW_BITS = 8 * sizeof(Row);
+    // The guard bits of one row, and of every row packed in a 64-bit word;
+    // they collide like blocks, which is what makes the walls solid
+    static constexpr Row WALL_ROW = static_cast<Row>(~(static_cast<Row>(FULL_ROW) << GUARD_BITS));
+    static constexpr uint64_t WALL_LANES = static_cast<uint64_t>(WALL_ROW) *
+        (ROW_BITS == 16 ? 0x0001000100010001ULL : ROW_BITS == 32 ? 0x0000000100000001ULL : 1ULL);
 };
 
+// Guideline playfield, the one the AI, replays and simulations use
+using Board = BasicBoard<10, 20>;
+
 #endif
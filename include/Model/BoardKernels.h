@@ -0,0 +1,54 @@
+#ifndef BOARD_KERNELS_H
+#define BOARD_KERNELS_H
+
+#include "Board.h"
+#include <cstddef>
+#include <cstdint>
+
+// A piece at a position, as the batched kernels take it
+struct PlacementProbe {
+    Tetromino piece;
+    int8_t x;
+    int8_t y;
+};
+
+static_assert(sizeof(PlacementProbe) == 4, "probes pack into four bytes");
+
+// Board queries over many placements or boards at a time, in AVX2 or SSE4.1
+// where the CPU has them and plain Board calls where it does not. The
+// instruction set is picked when the object is made, so one build runs on
+// any x86-64 machine; other targets always get the scalar path. Every path
+// returns exactly what the matching Board call would.
+//
+// The collision and landing kernels precompute the board's row windows or
+// column tops once per call, so they pay off on batches: every candidate
+// placement of a piece, or a search's whole frontier.
+class BoardKernels {
+public:
+    enum class Isa {
+        SCALAR,
+        SSE4,
+        AVX2
+    };
+
+    // The widest instruction set this CPU runs
+    static Isa getBestIsa();
+    static const char* getIsaName(Isa isa);
+
+    // Anything wider than getBestIsa() falls back to it
+    explicit BoardKernels(Isa isa = getBestIsa());
+    Isa getIsa() const;
+
+    // results[i] = board.canPlace(probes[i].piece, probes[i].x, probes[i].y)
+    void canPlace(const Board& board, const PlacementProbe* probes, size_t count, uint8_t* results) const;
+    // results[i] = board.getLandingY(...) for probes[i], each of which must
+    // be a legal position
+    void getLandingY(const Board& board, const PlacementProbe* probes, size_t count, int8_t* results) const;
+    // Bit y of masks[i] is set when boards[i].isRowFull(y)
+    void getFullRows(const Board* boards, size_t count, uint32_t* masks) const;
+
+private:
+    Isa isa;
+};
+
+#endif
@@ -2,6 +2,10 @@
 #define GAME_H
 
 #include "Board.h"
+#include "InputAction.h"
+#include "PieceGenerator.h"
+#include <array>
+#include <cstdint>
 #include "Tetromino.h"
 
 enum class GameState {
@@ -11,9 +15,34 @@ enum class GameState {
     GAME_OVER
 };
 
-class Game {
+// The engine for one board size; rules, scoring and timing are the same for
+// every size, and pieces spawn centred. Members are defined in Game.cpp and
+// instantiated there for the sizes BasicBoard is.
+template <int W, int H>
+class BasicGame {
 public:
-    Game();
+    using BoardType = BasicBoard<W, H>;
+
+    // Gravity is measured in ticks; one tick is one millisecond of play
+    static constexpr int TICKS_PER_SECOND = 1000;
+    // Bump whenever a change alters what a given seed and input stream
+    // produce, so old replays are rejected instead of diverging
+    static constexpr uint32_t ENGINE_VERSION = 2;
+
+    // The default constructor picks a non-deterministic seed; pass one
+    // explicitly for reproducible piece sequences
+    BasicGame();
+    explicit BasicGame(uint64_t seed);
+
+    // Seed and policy changes take effect from the next start()/reset(),
+    // which then restarts the piece stream
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const;
+    void setPiecePolicy(PiecePolicy policy);
+    PiecePolicy getPiecePolicy() const;
+    // How many upcoming pieces getPreview() can show, 1..MAX_PREVIEW
+    void setPreviewDepth(int depth);
+    int getPreviewDepth() const;
 
     void start();
     void pause();
@@ -30,24 +59,89 @@ public:
     void update();
     void spawnNewTetromino();
 
+    // The rotation rule rotate() and rotateCounterClockwise() apply,
+    // including wall kicks, for searches that work on a bare Board.
+    // Returns false and leaves the piece alone if no kick fits.
+    static bool rotateWithKicks(const BoardType& board, Tetromino& tetromino, int& x, int y, bool clockwise);
+    // The column offsets that rule tries, in order; a rotation uses the
+    // first getKickCount() of them: in place, one column either way, and
+    // clockwise also two columns (for the I-piece)
+    static constexpr int KICK_OFFSETS[] = {0, -1, 1, -2, 2};
+    static int getKickCount(bool clockwise);
+
+    // Headless step API: applyAction performs one input in the current
+    // state, advance runs gravity for the given number of ticks, and step
+    // does both in that order. QUIT and NONE are ignored by the engine.
+    bool applyAction(InputAction action);
+    void advance(int ticks);
+    void step(InputAction action, int ticks);
+
+    // Make/unmake for lookahead searches. makeMove locks `piece` at (x, y)
+    // as if gravity had brought it there: lines clear, score and level
+    // update and the next piece spawns. unmakeMove reverts the newest
+    // makeMove exactly. Both work on a fixed-capacity undo stack inside the
+    // Game and never allocate. makeMove returns false, changing nothing,
+    // when the game is not being played, the piece does not fit there or
+    // the stack is full.
+    static constexpr int MAX_UNDO_DEPTH = 16;
+    bool makeMove(const Tetromino& piece, int x, int y);
+    bool unmakeMove();
+    int getUndoDepth() const;
+
+    // Everything that decides how the game continues, so a position can be
+    // saved and resumed later exactly as this game would have carried on
+    // (replay keyframes). The undo stack is not part of it; restore()
+    // leaves the stack empty.
+    struct Snapshot {
+        std::array<typename BoardType::ColorRow, H> cells;
+        Tetromino current;
+        int x;
+        int y;
+        int score;
+        int level;
+        int linesCleared;
+        long long piecesPlaced;
+        long long tickCount;
+        int gravityTicks;
+        GameState state;
+        uint64_t seed;
+        PiecePolicy piecePolicy;
+        bool reseedPending;
+        PieceGenerator::Snapshot pieces;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot& snapshot);
+
     int getScore() const;
     int getLevel() const;
     int getLinesCleared() const;
+    long long getPiecesPlaced() const;
     GameState getState() const;
 
-    const Board& getBoard() const;
+    const BoardType& getBoard() const;
     const Tetromino& getCurrentTetromino() const;
     const Tetromino& getNextTetromino() const;
+    // Upcoming piece i, 0 being the next one; i < getPreviewDepth()
+    const Tetromino& getPreview(int i) const;
     int getCurrentX() const;
     int getCurrentY() const;
     int getGhostY() const;
 
     double getDropInterval() const;
+    int getDropIntervalTicks() const;
+    // The gravity interval at a given level
+    static int getDropIntervalTicks(int level);
+    // Ticks left before gravity next moves the piece, 0 if it is due now
+    int getTicksUntilDrop() const;
+    long long getTickCount() const;
+
+    static constexpr int LINES_PER_LEVEL = 10;
+    // Scoring based on original Nintendo scoring system
+    static constexpr int BASE_SCORE_PER_LINE[] = {0, 40, 100, 300, 1200};
 
 private:
-    Board board;
+    BoardType board;
     Tetromino currentTetromino;
-    Tetromino nextTetromino;
 
     int currentX;
     int currentY;
@@ -56,16 +150,42 @@ private:
     int level;
     int linesCleared;
     int totalLinesCleared;
+    long long piecesPlaced;
+
+    long long tickCount;
+    int gravityTicks;
 
     GameState state;
 
+    uint64_t seed;
+    PiecePolicy piecePolicy;
+    bool reseedPending;
+    PieceGenerator pieces;
+
+    struct MoveUndo {
+        typename BoardType::Undo board;
+        PieceGenerator::Checkpoint queue;
+        Tetromino piece;
+        int x;
+        int y;
+        int score;
+        int level;
+        int totalLinesCleared;
+        long long piecesPlaced;
+        int gravityTicks;
+        GameState state;
+        bool drewPiece;
+    };
+    std::array<MoveUndo, MAX_UNDO_DEPTH> undoStack;
+    int undoDepth;
+
     void lockTetromino();
     void updateScore(int lines);
     void updateLevel();
     int calculateGhostY() const;
-
-    static const int LINES_PER_LEVEL = 10;
-    static const int BASE_SCORE_PER_LINE[];
 };
 
+// The guideline game, the one the AI, replays and simulations use
+using Game = BasicGame<10, 20>;
+
 #endif
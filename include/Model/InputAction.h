@@ -0,0 +1,19 @@
+#ifndef INPUT_ACTION_H
+#define INPUT_ACTION_H
+
+enum class InputAction {
+    NONE,
+    MOVE_LEFT,
+    MOVE_RIGHT,
+    MOVE_DOWN,
+    HARD_DROP,
+    ROTATE_CW,
+    ROTATE_CCW,
+    PAUSE,
+    QUIT,
+    START,
+    RESTART,
+    TOGGLE_STATS   // front end only: the engine and replays never see it
+};
+
+#endif
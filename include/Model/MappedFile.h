@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A whole file mapped read-only, so readers can pick out the parts they
+// need without copying the rest. Where there is no mmap the file is read
+// into memory instead; callers see the same bytes either way.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Drops any file already open; fails on I/O errors, leaving a message
+    // in error
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const;
+    const uint8_t* data() const;
+    size_t size() const;
+
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped;
+    bool opened;
+    std::vector<uint8_t> buffer;   // the copy, where the file is not mapped
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef PIECE_GENERATOR_H
+#define PIECE_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include "Random.h"
+#include "Tetromino.h"
+
+enum class PiecePolicy : uint8_t {
+    UNIFORM,   // every piece drawn independently
+    BAG_7,     // shuffled bags holding each piece once
+    BAG_14     // shuffled bags holding each piece twice
+};
+
+// Per-game piece stream with its own seeded PRNG. Upcoming pieces sit in a
+// ring buffer that is topped up a whole bag (or, for UNIFORM, a whole
+// buffer) at a time, so the sequence depends only on the seed and the
+// policy, never on how deep the preview is.
+class PieceGenerator {
+public:
+    static const int MAX_PREVIEW = 16;
+    // Enough for a full preview plus one 14-bag
+    static const unsigned CAPACITY = 32;
+
+    // Stream position before a next() call, for taking that call back
+    struct Checkpoint {
+        Random rng;
+        unsigned head;
+        unsigned count;
+    };
+
+    PieceGenerator(uint64_t seed, PiecePolicy policy = PiecePolicy::UNIFORM, int previewDepth = 1);
+
+    // Restarts the stream from the seed and drops any queued pieces
+    void reseed(uint64_t seed, PiecePolicy policy);
+    PiecePolicy getPolicy() const;
+
+    // Clamped to [1, MAX_PREVIEW]; the sequence itself is unaffected
+    void setPreviewDepth(int depth);
+    int getPreviewDepth() const;
+
+    // Removes and returns the next piece
+    Tetromino next();
+    // Upcoming piece i, 0 being the one next() returns; i < getPreviewDepth()
+    const Tetromino& peek(int i) const;
+
+    Checkpoint checkpoint() const;
+    // Takes back the next() that followed `before` and returned `piece`.
+    // Calls must be undone newest first; any refill they triggered is
+    // dropped and will be redrawn identically.
+    void unget(const Tetromino& piece, const Checkpoint& before);
+
+    // The whole stream position: PRNG, settings and the pieces already
+    // drawn, next one first. restore() carries on from it exactly as the
+    // generator it was taken from would.
+    struct Snapshot {
+        Random rng;
+        PiecePolicy policy;
+        int previewDepth;
+        unsigned queuedCount;
+        std::array<Tetromino, CAPACITY> queued;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot& snapshot);
+
+    static const char* getPolicyName(PiecePolicy policy);
+    static bool parsePolicy(const char* name, PiecePolicy& policy);
+
+private:
+    static const unsigned MASK = CAPACITY - 1;
+    static_assert(MAX_PREVIEW + 1 + 2 * PIECE_TYPES <= static_cast<int>(CAPACITY),
+                  "a refill must fit behind a full preview");
+
+    Random rng;
+    PiecePolicy policy;
+    int previewDepth;
+
+    std::array<Tetromino, CAPACITY> queue;
+    unsigned head;
+    unsigned count;
+
+    void refill();
+};
+
+inline Tetromino PieceGenerator::next() {
+    Tetromino piece = queue[head];
+    head = (head + 1) & MASK;
+    --count;
+    if (count <= static_cast<unsigned>(previewDepth)) {
+        refill();
+    }
+    return piece;
+}
+
+inline const Tetromino& PieceGenerator::peek(int i) const {
+    return queue[(head + static_cast<unsigned>(i)) & MASK];
+}
+
+inline PieceGenerator::Checkpoint PieceGenerator::checkpoint() const {
+    return {rng, head, count};
+}
+
+inline void PieceGenerator::unget(const Tetromino& piece, const Checkpoint& before) {
+    // A refill may have reused the slot the piece was taken from
+    queue[before.head] = piece;
+    rng = before.rng;
+    head = before.head;
+    count = before.count;
+}
+
+#endif
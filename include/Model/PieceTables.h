@@ -0,0 +1,143 @@
+#ifndef PIECE_TABLES_H
+#define PIECE_TABLES_H
+
+#include <array>
+#include <cstdint>
+
+// Compile-time geometry for all 7 Tetrominoes with 4 rotation states each.
+// Everything below is derived from SHAPE_MATRICES by constexpr functions, so
+// the tables live in read-only data and cost nothing at startup.
+
+inline constexpr int PIECE_MATRIX_SIZE = 4;
+inline constexpr int PIECE_ROTATIONS = 4;
+inline constexpr int PIECE_TYPES = 7;
+
+using ShapeMatrix = std::array<std::array<int, PIECE_MATRIX_SIZE>, PIECE_MATRIX_SIZE>;
+
+struct CellOffset {
+    int8_t x;
+    int8_t y;
+};
+
+// Inclusive extent of the filled cells inside the 4x4 matrix
+struct PieceBounds {
+    int8_t minX;
+    int8_t minY;
+    int8_t maxX;
+    int8_t maxY;
+};
+
+struct PieceRotation {
+    ShapeMatrix shape;                                     // 1 = filled cell, 0 = empty
+    std::array<uint8_t, PIECE_MATRIX_SIZE> rowMasks;       // bit c set when shape[r][c] is filled
+    uint64_t rowMaskLanes;                                 // rowMasks[r] at bit 16 * r
+    std::array<CellOffset, PIECE_MATRIX_SIZE> cells;       // the four filled cells, row-major
+    std::array<int8_t, PIECE_MATRIX_SIZE> columnBottoms;   // lowest filled row of column c, -1 if empty
+    PieceBounds bounds;
+};
+
+// Indexed by TetrominoType (I, O, T, S, Z, J, L), then rotation state
+inline constexpr ShapeMatrix SHAPE_MATRICES[PIECE_TYPES][PIECE_ROTATIONS] = {
+    // I-piece rotations
+    {
+        {{{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}}},
+        {{{0,0,1,0}, {0,0,1,0}, {0,0,1,0}, {0,0,1,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}}},
+        {{{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}}}
+    },
+    // O-piece rotations (all same)
+    {
+        {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}}
+    },
+    // T-piece rotations
+    {
+        {{{0,0,0,0}, {0,1,0,0}, {1,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,1,0,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,1,0,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {0,1,0,0}}}
+    },
+    // S-piece rotations
+    {
+        {{{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,1,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {0,1,1,0}, {1,1,0,0}}},
+        {{{0,0,0,0}, {1,0,0,0}, {1,1,0,0}, {0,1,0,0}}}
+    },
+    // Z-piece rotations
+    {
+        {{{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,0,1,0}, {0,1,1,0}, {0,1,0,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {1,1,0,0}, {0,1,1,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {1,1,0,0}, {1,0,0,0}}}
+    },
+    // J-piece rotations
+    {
+        {{{0,0,0,0}, {1,0,0,0}, {1,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,1,0}, {0,1,0,0}, {0,1,0,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {0,0,1,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {1,1,0,0}}}
+    },
+    // L-piece rotations
+    {
+        {{{0,0,0,0}, {0,0,1,0}, {1,1,1,0}, {0,0,0,0}}},
+        {{{0,0,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,1,0}}},
+        {{{0,0,0,0}, {0,0,0,0}, {1,1,1,0}, {1,0,0,0}}},
+        {{{0,0,0,0}, {1,1,0,0}, {0,1,0,0}, {0,1,0,0}}}
+    }
+};
+
+constexpr PieceRotation makePieceRotation(const ShapeMatrix& shape) {
+    PieceRotation rotation{};
+    rotation.shape = shape;
+    rotation.bounds = {PIECE_MATRIX_SIZE, PIECE_MATRIX_SIZE, -1, -1};
+    rotation.columnBottoms = {-1, -1, -1, -1};
+
+    int cell = 0;
+    for (int row = 0; row < PIECE_MATRIX_SIZE; ++row) {
+        for (int col = 0; col < PIECE_MATRIX_SIZE; ++col) {
+            if (shape[row][col] == 0) {
+                continue;
+            }
+            rotation.rowMasks[row] = static_cast<uint8_t>(rotation.rowMasks[row] | (1u << col));
+            rotation.rowMaskLanes |= 1ULL << (16 * row + col);
+            rotation.columnBottoms[col] = static_cast<int8_t>(row);
+            if (cell < PIECE_MATRIX_SIZE) {
+                rotation.cells[cell++] = {static_cast<int8_t>(col), static_cast<int8_t>(row)};
+            }
+            if (col < rotation.bounds.minX) rotation.bounds.minX = static_cast<int8_t>(col);
+            if (row < rotation.bounds.minY) rotation.bounds.minY = static_cast<int8_t>(row);
+            if (col > rotation.bounds.maxX) rotation.bounds.maxX = static_cast<int8_t>(col);
+            if (row > rotation.bounds.maxY) rotation.bounds.maxY = static_cast<int8_t>(row);
+        }
+    }
+    return rotation;
+}
+
+// One extra all-empty row of entries at index PIECE_TYPES backs TetrominoType::NONE
+using PieceTable = std::array<std::array<PieceRotation, PIECE_ROTATIONS>, PIECE_TYPES + 1>;
+
+constexpr PieceTable makePieceTable() {
+    PieceTable table{};
+    for (int type = 0; type < PIECE_TYPES; ++type) {
+        for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+            table[type][rotation] = makePieceRotation(SHAPE_MATRICES[type][rotation]);
+        }
+    }
+    for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+        table[PIECE_TYPES][rotation].bounds = {0, 0, -1, -1};
+        table[PIECE_TYPES][rotation].columnBottoms = {-1, -1, -1, -1};
+    }
+    return table;
+}
+
+inline constexpr PieceTable PIECE_TABLE = makePieceTable();
+
+static_assert(PIECE_TABLE[0][0].rowMasks[1] == 0x0F, "I-piece spawn row mask");
+static_assert(PIECE_TABLE[0][0].rowMaskLanes == 0x0F0000, "I-piece spawn row lanes");
+static_assert(PIECE_TABLE[2][0].columnBottoms[1] == 2 && PIECE_TABLE[2][0].columnBottoms[3] == -1, "T-piece bottom profile");
+static_assert(PIECE_TABLE[2][1].bounds.minX == 1 && PIECE_TABLE[2][1].bounds.maxY == 3, "T-piece bounds");
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// xoshiro256** seeded through splitmix64. Small, fast and fully
+// deterministic, so each Game can own an independent stream.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0);
+
+    void seed(uint64_t seed);
+
+    uint64_t next();
+    // Uniform integer in [0, bound)
+    int nextInt(int bound);
+
+    // constexpr so tables of fixed keys can be drawn at compile time
+    static constexpr uint64_t splitMix64(uint64_t& state);
+
+    // The raw state words, for saving a stream position and resuming it
+    void getState(uint64_t words[4]) const;
+    void setState(const uint64_t words[4]);
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k);
+};
+
+constexpr uint64_t Random::splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t Random::rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t Random::next() {
+    const uint64_t result = rotl(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+}
+
+inline int Random::nextInt(int bound) {
+    // Lemire's multiply-shift; the bias for bounds this small is negligible
+    uint64_t high = (next() >> 32) * static_cast<uint64_t>(bound);
+    return static_cast<int>(high >> 32);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Game.h"
+#include "InputAction.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A session is the seed and piece policy plus every action the engine was
+// given, stamped with the session tick (total ticks passed to Game::advance
+// so far). The engine is deterministic in these, so that is enough to
+// replay it exactly.
+struct ReplayEvent {
+    long long tick;
+    InputAction action;
+};
+
+// Final state of the recorded session, checked after playback
+struct ReplaySummary {
+    long long endTick = 0;
+    int score = 0;
+    int level = 1;
+    int linesCleared = 0;
+    long long piecesPlaced = 0;
+    uint64_t digest = 0;
+};
+
+class Replay {
+public:
+    static const uint16_t FORMAT_VERSION = 3;
+
+    uint64_t seed = 0;
+    PiecePolicy piecePolicy = PiecePolicy::UNIFORM;
+    uint32_t engineVersion = 0;
+    std::vector<ReplayEvent> events;
+    ReplaySummary summary;
+
+    // Reads a replay or a ReplayArchive. Fails on I/O errors, corrupt files
+    // and files from another engine version, leaving a message in error
+    static bool load(const std::string& path, Replay& replay, std::string& error);
+    // The same for a replay (not an archive) already in memory; `name`
+    // only goes into error messages
+    static bool parse(const uint8_t* data, size_t size, const std::string& name, Replay& replay,
+                      std::string& error);
+
+    // Hash of everything that decides how the game continues: board,
+    // pieces, position, score fields, state and gravity progress
+    static uint64_t digest(const Game& game);
+
+    // Game::advance for a gap between recorded ticks, which a corrupt or
+    // hostile file can make longer than an int: the gap goes in bounded
+    // spans, and only while the game is playing, since gravity does nothing
+    // otherwise and a long enough span always ends the game
+    static void advance(Game& game, long long ticks);
+};
+
+// Appends events to an in-memory log as they happen (a varint tick delta
+// and one action byte each); nothing touches the disk until save()
+class ReplayRecorder {
+public:
+    ReplayRecorder(uint64_t seed, PiecePolicy piecePolicy);
+
+    // Call with every action passed to Game::applyAction and every tick
+    // count passed to Game::advance, in the order they were made
+    void record(InputAction action);
+    void advance(int ticks);
+
+    long long getTick() const;
+    size_t getEventCount() const;
+
+    bool save(const std::string& path, const Game& finalState, std::string& error) const;
+
+private:
+    uint64_t seed;
+    PiecePolicy piecePolicy;
+    long long tick;
+    long long lastEventTick;
+    size_t eventCount;
+    std::vector<uint8_t> body;
+
+    static const size_t INITIAL_CAPACITY = 64 * 1024;
+};
+
+// Feeds a replay's events into a Game at their recorded ticks. The game
+// must still be on the menu; the player sets its seed and piece policy.
+class ReplayPlayer {
+public:
+    ReplayPlayer(const Replay& replay, Game& game);
+
+    // Plays every event up to and including the given session tick and
+    // runs gravity up to it; ticks past the end of the recording are ignored
+    void advanceTo(long long tick);
+    void runToEnd();
+    // Plays the events before index `event` and runs gravity up to `tick`,
+    // which should not be past that event's; the event itself is left
+    // unplayed even when stamped with `tick`, for stopping between events
+    // that share a tick
+    void playUntil(size_t event, long long tick);
+
+    long long getTick() const;
+    size_t getPlayedEvents() const;
+    // Session tick of the next event, or the end tick once all are played
+    long long getNextEventTick() const;
+    bool isFinished() const;
+
+    // True if the game ended exactly where the recording did
+    bool matchesRecording() const;
+
+private:
+    const Replay& replay;
+    Game& game;
+    size_t nextEvent;
+    long long tick;
+};
+
+#endif
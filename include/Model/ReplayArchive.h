@@ -0,0 +1,128 @@
+#ifndef REPLAY_ARCHIVE_H
+#define REPLAY_ARCHIVE_H
+
+#include "Game.h"
+#include "MappedFile.h"
+#include "Replay.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A replay for long sessions: the same inputs as a Replay, cut into blocks
+// that each open with a full snapshot of the game and are compressed on
+// their own, plus an index of the blocks at the end of the file. A reader
+// finds the block for any piece or tick by binary search over the index,
+// restores its snapshot and plays at most one block's inputs, so seeking
+// costs the same at the start of a session as ten hours in.
+//
+// Piece numbers count every piece locked in the session, across restarts,
+// so they only ever go up.
+struct ReplayKeyframe {
+    uint64_t offset;            // of the compressed block in the file
+    uint32_t compressedSize;
+    uint32_t rawSize;
+    long long tick;             // session tick the snapshot was taken at
+    long long pieces;           // pieces locked before it
+    long long firstEvent;       // index of the block's first event
+    uint32_t eventCount;
+};
+
+class ReplayArchive {
+public:
+    static const uint16_t FORMAT_VERSION = 1;
+    // Pieces between keyframes; each costs a few hundred bytes before
+    // compression, and a seek replays up to this many pieces
+    static const int DEFAULT_KEYFRAME_INTERVAL = 256;
+
+    ReplayArchive();
+
+    // Maps the file and checks its header, index and trailer; blocks are
+    // only decoded when a seek reaches them. Fails on I/O errors, corrupt
+    // files and files from another engine version, leaving a message in
+    // error.
+    bool open(const std::string& path, std::string& error);
+
+    // The seed and piece policy the session started with
+    uint64_t getSeed() const;
+    PiecePolicy getPiecePolicy() const;
+    int getKeyframeInterval() const;
+    const std::vector<ReplayKeyframe>& getKeyframes() const;
+    long long getEventCount() const;
+    // Pieces locked over the whole session
+    long long getPieceCount() const;
+    // The final state, as a Replay records it
+    const ReplaySummary& getSummary() const;
+
+    // Puts `game` where the session stood right after its piece-th piece
+    // locked, or at the start for 0, and sets `tick` to the session tick
+    // there. Fails for pieces the session never reached.
+    bool seekToPiece(long long piece, Game& game, long long& tick, std::string& error) const;
+    // Puts `game` where the session stood at `tick`, every event stamped
+    // with it played; ticks past the end stop at the end
+    bool seekToTick(long long tick, Game& game, std::string& error) const;
+
+    // Decodes every event, for playing the whole session with ReplayPlayer
+    bool readReplay(Replay& replay, std::string& error) const;
+    // Decompresses keyframe i's block into its snapshot and the events
+    // that follow it, up to the next keyframe
+    bool readBlock(size_t i, Game::Snapshot& snapshot, std::vector<ReplayEvent>& events, std::string& error) const;
+
+private:
+    MappedFile file;
+    std::string path;
+    uint64_t seed;
+    PiecePolicy piecePolicy;
+    int keyframeInterval;
+    std::vector<ReplayKeyframe> keyframes;
+    long long eventCount;
+    long long pieceCount;
+    ReplaySummary summary;
+
+    long long getBlockEndTick(size_t i) const;
+};
+
+// Writes a ReplayArchive while the session is played. Like ReplayRecorder
+// it is told every input as it happens, and it also watches the game to
+// take a snapshot every keyframeInterval pieces. Finished blocks are kept
+// compressed in memory; nothing touches the disk until save().
+class ReplayArchiveWriter {
+public:
+    // The game must outlive the writer. The first keyframe is the game as
+    // it is now, and the archive's seed and policy are the game's.
+    explicit ReplayArchiveWriter(const Game& game, int keyframeInterval = ReplayArchive::DEFAULT_KEYFRAME_INTERVAL);
+
+    // Call right after every Game::applyAction and every Game::advance (or
+    // Replay::advance), in the order they were made
+    void record(InputAction action);
+    void advance(long long ticks);
+
+    long long getTick() const;
+    size_t getEventCount() const;
+    size_t getKeyframeCount() const;
+
+    bool save(const std::string& path, std::string& error) const;
+
+private:
+    const Game& game;
+    uint64_t seed;
+    PiecePolicy piecePolicy;
+    int keyframeInterval;
+    long long tick;
+    long long lastEventTick;
+    size_t eventCount;
+    // Pieces locked over the session, and the game's own count when it
+    // was last looked at, to spot restarts
+    long long pieces;
+    long long lastPiecesPlaced;
+    long long nextKeyframePieces;
+
+    std::vector<ReplayKeyframe> keyframes;
+    std::vector<uint8_t> blocks;    // compressed, back to back
+    std::vector<uint8_t> openBlock; // the newest block, not yet compressed
+
+    void observe();
+    void beginBlock();
+    void closeBlock();
+};
+
+#endif
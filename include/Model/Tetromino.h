@@ -1,16 +1,19 @@
 #ifndef TETROMINO_H
 #define TETROMINO_H
 
-#include <vector>
 #include <array>
+#include <cstdint>
+#include "PieceTables.h"
+#include "Random.h"
 
-enum class TetrominoType {
+enum class TetrominoType : uint8_t {
     I, O, T, S, Z, J, L, NONE
 };
 
+// Flyweight handle: a (type, rotation) pair indexing the constexpr PIECE_TABLE
 class Tetromino {
 public:
-    static const int MATRIX_SIZE = 4;
+    static const int MATRIX_SIZE = PIECE_MATRIX_SIZE;
 
     Tetromino();
     explicit Tetromino(TetrominoType type);
@@ -20,20 +23,56 @@ public:
 
     TetrominoType getType() const;
     int getRotationState() const;
-    const std::array<std::array<int, MATRIX_SIZE>, MATRIX_SIZE>& getShape() const;
+    const ShapeMatrix& getShape() const;
+    // Bit c of getRowMasks()[r] is set when getShape()[r][c] is filled
+    const std::array<uint8_t, MATRIX_SIZE>& getRowMasks() const;
+    // The same masks packed into one word, row r at bit 16 * r
+    uint64_t getRowMaskLanes() const;
+    const std::array<CellOffset, MATRIX_SIZE>& getCells() const;
+    // Lowest filled row of each matrix column, -1 for empty columns
+    const std::array<int8_t, MATRIX_SIZE>& getColumnBottoms() const;
+    const PieceBounds& getBounds() const;
     char getDisplayChar() const;
 
-    static Tetromino createRandom();
+    static Tetromino createRandom(Random& rng);
 
 private:
     TetrominoType type;
-    int rotationState;
-    std::array<std::array<int, MATRIX_SIZE>, MATRIX_SIZE> shape;
+    uint8_t rotationState;
 
-    void initializeShape();
-    void applyRotation();
-
-    static const std::vector<std::array<std::array<int, MATRIX_SIZE>, MATRIX_SIZE>>& getShapeDefinitions(TetrominoType type);
+    const PieceRotation& getRotationData() const;
 };
 
+static_assert(sizeof(Tetromino) == 2, "Tetromino should stay a (type, rotation) pair");
+
+// Table lookups are inline so collision checks compile down to a load
+inline const PieceRotation& Tetromino::getRotationData() const {
+    // NONE maps onto the empty entry at the end of the table
+    return PIECE_TABLE[static_cast<int>(type)][rotationState];
+}
+
+inline const ShapeMatrix& Tetromino::getShape() const {
+    return getRotationData().shape;
+}
+
+inline const std::array<uint8_t, Tetromino::MATRIX_SIZE>& Tetromino::getRowMasks() const {
+    return getRotationData().rowMasks;
+}
+
+inline uint64_t Tetromino::getRowMaskLanes() const {
+    return getRotationData().rowMaskLanes;
+}
+
+inline const std::array<CellOffset, Tetromino::MATRIX_SIZE>& Tetromino::getCells() const {
+    return getRotationData().cells;
+}
+
+inline const std::array<int8_t, Tetromino::MATRIX_SIZE>& Tetromino::getColumnBottoms() const {
+    return getRotationData().columnBottoms;
+}
+
+inline const PieceBounds& Tetromino::getBounds() const {
+    return getRotationData().bounds;
+}
+
 #endif
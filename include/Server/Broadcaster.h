@@ -0,0 +1,65 @@
+#ifndef BROADCASTER_H
+#define BROADCASTER_H
+
+#include "../Model/Game.h"
+#include "../View/Renderer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// One encoded spectator frame. It is built once and then shared, read
+// only, by every viewer it is queued for.
+struct BroadcastFrame {
+    std::vector<char> bytes;
+    // Redraws the whole screen from blank, so a viewer can start here
+    bool keyframe = false;
+    uint64_t sequence = 0;
+};
+
+using BroadcastFramePtr = std::shared_ptr<const BroadcastFrame>;
+
+// Encodes one game for its spectators. A private Renderer keeps the screen
+// the spectators last saw, so each frame is the FrameBuffer diff: only
+// the cells that changed, piece, score and sidebar fields included. A
+// keyframe clears the screen and draws every cell. Keyframes go out when a
+// viewer joins, when one has fallen behind, and every KEYFRAME_INTERVAL_MS
+// while the game is changing. Times are milliseconds on the server's clock.
+class Broadcaster {
+public:
+    Broadcaster(int boardWidth, int boardHeight, uint64_t now);
+    Broadcaster(const Broadcaster&) = delete;
+    Broadcaster& operator=(const Broadcaster&) = delete;
+
+    // The next frame is a keyframe, for a viewer that just joined
+    void requestKeyframe();
+    // A keyframe within the keyframe interval, even if the game is idle,
+    // for a viewer that dropped frames and is waiting to resync
+    void requestCatchUp();
+
+    // Encodes a frame if one is due at `now`; nullptr otherwise.
+    // `changeCount` is Session::getChangeCount().
+    BroadcastFramePtr poll(const Game& game, uint64_t changeCount, uint64_t now);
+    // When poll() next has work, UINT64_MAX if nothing is pending
+    uint64_t getNextDeadline(uint64_t changeCount) const;
+
+    uint64_t getFrameCount() const;
+    uint64_t getKeyframeCount() const;
+    size_t getMemoryBytes() const;
+
+private:
+    Renderer renderer;
+    std::vector<char> outbox;
+    uint64_t lastChangeCount;
+    uint64_t lastFrameTime;
+    uint64_t lastKeyframeTime;
+    bool keyframeRequested;
+    bool catchUpRequested;
+    uint64_t frameCount;
+    uint64_t keyframeCount;
+
+    static const int FRAME_DURATION_MS = 16;
+    static const int KEYFRAME_INTERVAL_MS = 2000;
+};
+
+#endif
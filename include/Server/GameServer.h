@@ -0,0 +1,152 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "../View/FrameStats.h"
+#include "Broadcaster.h"
+#include "Session.h"
+#include "TimerWheel.h"
+#include "Viewer.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ServerConfig {
+    // A unix socket path takes precedence over host and port
+    std::string unixPath;
+    std::string host = "127.0.0.1";
+    int port = 7777;
+    // Connections beyond this are closed as soon as they are accepted
+    size_t maxSessions = 10000;
+    SessionConfig session;
+
+    // Spectators connect here, to a unix socket if a path is set, else to
+    // the TCP port on host; -1 turns spectating off
+    std::string spectateUnixPath;
+    int spectatePort = -1;
+    size_t maxSpectators = 10000;
+};
+
+struct ServerStats {
+    // Player connections; spectators are counted on their own below
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+    uint64_t closed = 0;
+    size_t sessions = 0;
+    size_t peakSessions = 0;
+    size_t spectators = 0;
+    size_t peakSpectators = 0;
+    uint64_t spectatorsAccepted = 0;
+    uint64_t spectatorsRejected = 0;
+    uint64_t wakeups = 0;           // epoll_wait returns
+    uint64_t timersFired = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t busyNanos = 0;         // time spent outside epoll_wait
+    uint64_t broadcastFrames = 0;   // encoded once each, however many watch
+    uint64_t keyframes = 0;
+    uint64_t framesQueued = 0;      // frames handed to viewers
+    uint64_t framesDropped = 0;     // skipped by viewers that fell behind
+    Histogram keyLatencyNanos;      // key read to its frame handed to the socket
+};
+
+// Plays many independent games over TCP or a unix socket from a single
+// thread. One epoll set watches every connection and a timer wheel holds
+// each session's next gravity step or frame, so the loop sleeps until a key
+// arrives or the earliest deadline and then touches only the sessions with
+// work. Output goes through each session's outbox; a client that stops
+// reading only stalls its own frames.
+//
+// Spectators watch a game of their choosing. Each watched game has a
+// Broadcaster that encodes every frame once; all its viewers queue the
+// same shared buffer.
+class GameServer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ReportFn = std::function<void(const GameServer&)>;
+
+    explicit GameServer(const ServerConfig& config);
+    ~GameServer();
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    bool listen(std::string& error);
+    // Serves until stop(), calling report every reportMillis if both are set
+    bool run(std::string& error, int reportMillis = 0, const ReportFn& report = ReportFn());
+    // Safe from a signal handler or another thread
+    void stop();
+
+    const ServerStats& getStats() const;
+    // Bytes held by live sessions (their broadcasters included) and by
+    // spectators, summed over them now
+    size_t getSessionMemoryBytes() const;
+    size_t getSpectatorMemoryBytes() const;
+    std::string getAddress() const;
+    std::string getSpectateAddress() const;
+
+private:
+    static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+    // A connection: a player's session or a spectator's viewer
+    struct Slot {
+        std::unique_ptr<Session> session;
+        std::unique_ptr<Viewer> viewer;
+        int fd = -1;
+        bool closing = false;
+        bool watchingWrites = false;
+        // Players: the spectator encoder, while anyone watches, and who does
+        std::unique_ptr<Broadcaster> broadcaster;
+        std::vector<size_t> viewers;
+        // Viewers: the player slot being watched, NO_SLOT while none
+        size_t watching = NO_SLOT;
+    };
+
+    ServerConfig config;
+    ServerStats stats;
+    int listenFd;
+    int spectateFd;
+    int epollFd;
+    int wakeFd;
+    std::atomic<bool> stopping;
+    Clock::time_point epoch;
+
+    std::vector<Slot> slots;
+    std::vector<size_t> freeSlots;
+    std::vector<size_t> closingSlots;
+    // Viewers waiting for someone to start playing
+    std::vector<size_t> idleViewers;
+    TimerWheel wheel;
+    TimerWheel::Timer reportTimer;
+
+    uint64_t now() const;
+    int openListener(const std::string& unixPath, int port, std::string& error);
+    void acceptAll(int listener, bool spectators);
+    size_t allocateSlot(int fd);
+    void handleReadable(size_t index);
+    // Ticks the session, sends what it can and re-arms its timer
+    void service(size_t index, uint64_t time);
+    // Encodes a spectator frame for a watched game and queues it for every
+    // viewer; returns when the next one may be due
+    uint64_t broadcast(size_t index, uint64_t time);
+    void attachViewer(size_t viewer, size_t player, uint64_t time);
+    void detachViewer(size_t viewer);
+    // The next live player after `from` going forwards or backwards,
+    // NO_SLOT if there is none
+    size_t findPlayer(size_t from, bool forwards) const;
+    // Sends a viewer to another game, or parks it if none is left
+    void rehomeViewer(size_t viewer, size_t from, uint64_t time);
+    void flush(size_t index);
+    void watchWrites(size_t index, bool enabled);
+    void close(size_t index);
+    void reapClosed();
+    void shutdown();
+
+    static const size_t MAX_PENDING_OUTPUT = 256 * 1024;
+    static const size_t READ_BUFFER_SIZE = 4096;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "../Controller/KeyDecoder.h"
+#include "../Model/Game.h"
+#include "../View/Renderer.h"
+#include "TelnetFilter.h"
+#include "TimerWheel.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SessionConfig {
+    PiecePolicy piecePolicy = PiecePolicy::UNIFORM;
+    int previewDepth = 1;
+    // Negotiate character-at-a-time mode with telnet clients on connect;
+    // off for clients that already send raw bytes
+    bool telnet = true;
+};
+
+// One connected player: a Game, the Renderer drawing it and the output not
+// yet sent. A session does no I/O itself. GameServer passes it the bytes
+// read from the client, calls tick() when its deadline comes and sends
+// whatever collects in the outbox. Times are milliseconds on the server's
+// clock.
+//
+// The rules follow GameController: Enter starts, P pauses, R restarts after
+// game over and Q leaves. Frames are paced like the terminal front end, and
+// a new frame is only drawn once the previous one has been sent in full, so
+// a slow client gets fewer, larger frames rather than a growing backlog.
+class Session {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Session(const SessionConfig& config, uint64_t now);
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    // Handles bytes from the client read at `readTime`. Returns false once
+    // the player has quit; the farewell is then in the outbox.
+    bool receive(const unsigned char* data, size_t size, uint64_t now, Clock::time_point readTime);
+    // Runs gravity up to `now` and draws a frame if one is owed
+    void tick(uint64_t now);
+    // When tick() next has work, UINT64_MAX if nothing happens until the
+    // client types or the outbox drains
+    uint64_t getNextDeadline() const;
+
+    const char* getOutput() const;
+    size_t getOutputSize() const;
+    // Marks `count` bytes of output as sent at `sentTime`. Returns true
+    // with `latencyNanos` set when that completed a frame answering a key:
+    // the time from the earliest key it shows being read.
+    bool consumeOutput(size_t count, Clock::time_point sentTime, uint64_t& latencyNanos);
+
+    // The session object plus the heap it holds
+    size_t getMemoryBytes() const;
+    const Game& getGame() const;
+    // Goes up whenever a key or gravity may have changed the screen, so
+    // spectators can tell when to draw
+    uint64_t getChangeCount() const;
+
+    // For the server's timer wheel
+    TimerWheel::Timer timer;
+
+private:
+    Game game;
+    Renderer renderer;
+    KeyDecoder decoder;
+    TelnetFilter telnet;
+
+    std::vector<char> outbox;
+    size_t outboxSent;
+
+    uint64_t lastTickTime;
+    uint64_t lastRenderTime;
+    bool needsRender;
+    uint64_t changes;
+    bool quit;
+
+    // Earliest key not yet in a drawn frame, and the one the frame in the
+    // outbox answers
+    bool keyWaiting;
+    Clock::time_point keyTime;
+    bool frameAnswersKey;
+    Clock::time_point frameKeyTime;
+
+    void handleAction(InputAction action, uint64_t now);
+    void update(uint64_t now);
+    void render();
+
+    static const int FRAME_DURATION_MS = 16;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef TELNET_FILTER_H
+#define TELNET_FILTER_H
+
+#include <cstddef>
+
+// Strips telnet commands (RFC 854) out of a client's byte stream, leaving
+// only the keys typed. Commands can be split across reads like escape
+// sequences, so the filter remembers where it is between calls.
+class TelnetFilter {
+public:
+    TelnetFilter() : state(State::DATA) {}
+
+    // Removes commands from `data` in place; returns how many bytes remain
+    size_t filter(unsigned char* data, size_t size);
+
+    // IAC WILL ECHO, IAC WILL SUPPRESS-GO-AHEAD: sent on connect so the
+    // client neither echoes nor waits for Enter
+    static const char CHARACTER_MODE[6];
+
+private:
+    enum class State {
+        DATA,
+        COMMAND,      // after IAC
+        OPTION,       // after IAC WILL/WONT/DO/DONT
+        SUBNEGOTIATION,
+        SUBNEGOTIATION_COMMAND
+    };
+    State state;
+};
+
+#endif
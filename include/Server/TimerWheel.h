@@ -0,0 +1,93 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Hashed timing wheel with one-millisecond slots. Timers are intrusive
+// nodes owned by the caller, so scheduling, rescheduling and cancelling are
+// O(1) and never allocate. A deadline further out than the wheel spans
+// simply stays in its slot for extra laps until it comes due.
+class TimerWheel {
+public:
+    static const int SLOT_BITS = 10;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    struct Timer {
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+        uint64_t deadline = 0;
+        bool armed = false;
+        size_t tag = 0;   // for the owner, e.g. which session this is
+    };
+
+    // Times are milliseconds on any monotonic clock; `now` is where the
+    // wheel starts
+    explicit TimerWheel(uint64_t now);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Arms `timer` for `deadline`, moving it if it was already armed. A
+    // deadline in the past fires on the next advance().
+    void schedule(Timer& timer, uint64_t deadline);
+    void cancel(Timer& timer);
+
+    // Fires every timer due at or before `now`, calling fire(timer) once
+    // each after disarming it; fire may schedule timers again
+    template <typename Fire>
+    void advance(uint64_t now, Fire&& fire);
+
+    // Milliseconds until the next slot holding a timer comes up, capped at
+    // one lap; -1 when nothing is armed. Suits epoll_wait's timeout.
+    int getTimeout(uint64_t now) const;
+    size_t getArmedCount() const;
+
+private:
+    // Each slot is a circular list with the slot itself as sentinel
+    std::array<Timer, SLOTS> slots;
+    uint64_t current;   // every slot up to here has been fired
+    size_t armedCount;
+
+    void link(Timer& timer);
+    static void unlink(Timer& timer);
+};
+
+template <typename Fire>
+void TimerWheel::advance(uint64_t now, Fire&& fire) {
+    if (now <= current) {
+        return;
+    }
+    // Past one lap every slot gets visited anyway
+    uint64_t first = now - current > SLOTS ? now - SLOTS + 1 : current + 1;
+    current = now;
+
+    for (uint64_t tick = first; tick <= now; ++tick) {
+        Timer& head = slots[tick & (SLOTS - 1)];
+        // Due timers move to a private list before any fires, so callbacks
+        // that reschedule into this slot cannot be fired twice
+        Timer due;
+        due.prev = &due;
+        due.next = &due;
+        for (Timer* timer = head.next; timer != &head;) {
+            Timer* next = timer->next;
+            if (timer->deadline <= now) {
+                unlink(*timer);
+                timer->prev = due.prev;
+                timer->next = &due;
+                due.prev->next = timer;
+                due.prev = timer;
+            }
+            timer = next;
+        }
+        while (due.next != &due) {
+            Timer* timer = due.next;
+            unlink(*timer);
+            timer->armed = false;
+            --armedCount;
+            fire(*timer);
+        }
+    }
+}
+
+#endif
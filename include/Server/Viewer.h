@@ -0,0 +1,77 @@
+#ifndef VIEWER_H
+#define VIEWER_H
+
+#include "../Controller/KeyDecoder.h"
+#include "Broadcaster.h"
+#include "TelnetFilter.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+enum class ViewerRequest {
+    NONE,
+    NEXT_GAME,
+    PREVIOUS_GAME,
+    QUIT
+};
+
+// A spectator connection: the frames queued for it and how much of the
+// first has been sent. The frames are shared with every other viewer of
+// the same game. A viewer more than MAX_QUEUED_BYTES behind drops
+// everything it has not started sending and skips ahead to the next
+// keyframe. One that keeps falling behind without sending a byte, or whose
+// control frames alone pass the limit, is stalled and gets closed, so one
+// stalled screen costs a bounded amount of memory.
+class Viewer {
+public:
+    explicit Viewer(bool telnet);
+    Viewer(const Viewer&) = delete;
+    Viewer& operator=(const Viewer&) = delete;
+
+    // Left/right (arrows or A/D) pick another game; Q leaves
+    ViewerRequest receive(const unsigned char* data, size_t size);
+
+    // Queues `frame`, or drops it while waiting for a keyframe
+    void push(const BroadcastFramePtr& frame);
+    // Moves to another game: what is queued from this one is dropped and
+    // the viewer waits for the new game's keyframe
+    void switchGame();
+    // Replaces the screen with `text`, e.g. while nobody is playing
+    void showMessage(const char* text);
+    // Restores the cursor and clears the screen before disconnecting
+    void sayGoodbye();
+
+    bool isWaitingForKeyframe() const;
+    // True once the connection should be closed: MAX_STALLED_OVERFLOWS
+    // overflows in a row with nothing sent between them, or more than
+    // MAX_QUEUED_BYTES queued with control frames counted
+    bool isStalled() const;
+    const char* getOutput() const;
+    size_t getOutputSize() const;
+    void consumeOutput(size_t count);
+
+    uint64_t getDroppedFrames() const;
+    // The viewer and its queue; the frames themselves are shared and not
+    // counted
+    size_t getMemoryBytes() const;
+
+private:
+    std::deque<BroadcastFramePtr> queue;
+    size_t headSent;
+    size_t queuedBytes;
+    bool waitingForKeyframe;
+    int overflowsWithoutProgress;
+    uint64_t droppedFrames;
+    TelnetFilter telnet;
+    KeyDecoder decoder;
+
+    // Drops every broadcast frame not yet started and resets the
+    // terminal's style, which the dropped frames may have changed
+    void dropUnsent();
+    void pushPrivate(const BroadcastFramePtr& frame);
+
+    static const size_t MAX_QUEUED_BYTES = 64 * 1024;
+    static const int MAX_STALLED_OVERFLOWS = 4;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "Policy.h"
+#include <cstdint>
+
+struct SimConfig {
+    uint64_t games = 1000;
+    uint64_t seed = 1;
+    unsigned threads = 0;         // 0 = one per hardware thread
+    int ticksPerAction = 16;      // gravity time that passes between inputs
+    long long maxPieces = 100000; // cap per game so strong policies terminate
+    PiecePolicy piecePolicy = PiecePolicy::UNIFORM;
+};
+
+struct SimStats {
+    uint64_t games = 0;
+    uint64_t pieces = 0;
+    uint64_t actions = 0;
+    uint64_t lines = 0;
+    uint64_t scoreSum = 0;
+    double scoreSumSquares = 0.0;
+    int minScore = 0;
+    int maxScore = 0;
+    int maxLines = 0;
+    int maxLevel = 0;
+    double elapsedSeconds = 0.0;
+    unsigned threads = 0;
+
+    void addGame(const Game& game, uint64_t gameActions);
+    void merge(const SimStats& other);
+
+    double getMeanScore() const;
+    double getScoreStdDev() const;
+};
+
+// Plays a batch of independent games across a WorkStealingPool. Game i is
+// seeded from (config.seed, i) alone, so the games played do not depend on
+// the thread count or on which worker ran which game.
+class BatchRunner {
+public:
+    BatchRunner(const SimConfig& config, const Policy& prototype);
+
+    SimStats run();
+
+    static uint64_t gameSeed(uint64_t baseSeed, uint64_t gameIndex);
+
+private:
+    SimConfig config;
+    const Policy& prototype;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef GAME_POOL_H
+#define GAME_POOL_H
+
+#include "../Model/Game.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Many standard games stored field by field instead of as Game objects, for
+// workloads that keep millions of games live at once. Each board is 32 row
+// words in one cache line, the falling piece is packed into four bytes and
+// the upcoming pieces into one word, and score, level, lines and the rest
+// sit in arrays of their own, so a pass over every game streams through
+// memory in order and a pass that reads only the states touches one byte
+// per game.
+//
+// The rules are Game's: for the same seed, piece policy and inputs a pool
+// game goes through exactly the states a Game does, and any change to one
+// has to be made to the other. Only the preview depth is fixed at one.
+class GamePool {
+public:
+    static constexpr int WIDTH = Board::WIDTH;
+    static constexpr int HEIGHT = Board::HEIGHT;
+
+    // Games start in MENU with seed 0 and the UNIFORM policy, like Game(0)
+    explicit GamePool(size_t size = 0);
+
+    size_t size() const;
+    // Games past the old size are added as the constructor makes them
+    void resize(size_t size);
+
+    // Restarts game i's piece stream from `seed` and puts it back in MENU;
+    // unlike Game::setSeed this applies at once, not at the next start
+    void seed(size_t game, uint64_t seed, PiecePolicy policy = PiecePolicy::UNIFORM);
+
+    // Game::applyAction, advance and step on game i
+    bool applyAction(size_t game, InputAction action);
+    void advance(size_t game, int ticks);
+    void step(size_t game, InputAction action, int ticks);
+
+    // The same over every game in one pass, game i taking actions[i]
+    void applyActions(const InputAction* actions);
+    void advanceAll(int ticks);
+    void stepAll(const InputAction* actions, int ticks);
+    // Starts every finished game again, continuing its piece stream as
+    // RESTART does; returns how many there were
+    size_t restartFinished();
+
+    GameState getState(size_t game) const;
+    int getScore(size_t game) const;
+    int getLevel(size_t game) const;
+    int getLinesCleared(size_t game) const;
+    long long getPiecesPlaced(size_t game) const;
+    long long getTickCount(size_t game) const;
+    Tetromino getCurrentTetromino(size_t game) const;
+    Tetromino getNextTetromino(size_t game) const;
+    int getCurrentX(size_t game) const;
+    int getCurrentY(size_t game) const;
+    int getTicksUntilDrop(size_t game) const;
+    // Occupancy of row y, bit x = column x, as Board::getRow gives it
+    Board::Row getRow(size_t game, int y) const;
+
+    // Bytes held by the arrays, spare capacity included
+    size_t getMemoryBytes() const;
+
+private:
+    static constexpr int GUARD_BITS = Tetromino::MATRIX_SIZE - 1;
+    // Board row y is words[PAD_ROWS + y]. Rows are stored already shifted
+    // past the guard bits with the walls set, the pad rows above the
+    // board hold only walls and those below are solid, so a collision
+    // check is a shift and an AND over four rows loaded as one word.
+    static constexpr int PAD_ROWS = Tetromino::MATRIX_SIZE;
+    static constexpr uint16_t WALL_ROW = static_cast<uint16_t>(~(Board::FULL_ROW << GUARD_BITS));
+    static constexpr uint16_t SOLID_ROW = 0xFFFF;
+    static_assert(WIDTH + 2 * GUARD_BITS == 16, "pool rows are 16-bit words");
+
+    struct alignas(64) Rows {
+        std::array<uint16_t, 32> words;
+    };
+    static_assert(PAD_ROWS + HEIGHT + PAD_ROWS <= 32, "a board fits one cache line");
+
+    struct PieceState {
+        Tetromino piece;
+        int8_t x;
+        int8_t y;
+    };
+    static_assert(sizeof(PieceState) == 4, "piece state packs into four bytes");
+
+    std::vector<Rows> boards;
+    std::vector<PieceState> current;
+    std::vector<uint8_t> states;          // GameState
+    std::vector<int32_t> gravityTicks;
+    std::vector<int32_t> scores;
+    std::vector<int32_t> levels;
+    std::vector<int32_t> lines;
+    std::vector<int64_t> piecesPlaced;
+    std::vector<int64_t> tickCounts;
+    // Piece streams: each game's PRNG and its upcoming pieces, four bits
+    // per piece with the next one lowest, refilled as PieceGenerator does
+    std::vector<Random> rngs;
+    std::vector<uint64_t> queues;
+    std::vector<uint8_t> queueCounts;
+    std::vector<uint8_t> policies;        // PiecePolicy
+
+    bool canPlace(size_t game, Tetromino piece, int x, int y) const;
+    bool move(size_t game, int dx, int dy);
+    void rotate(size_t game, bool clockwise);
+    void start(size_t game);
+    void lock(size_t game);
+    void spawn(size_t game);
+    Tetromino drawPiece(size_t game);
+    void refillQueue(size_t game);
+
+    static int getDropIntervalTicks(int level);
+};
+
+#endif
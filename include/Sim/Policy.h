@@ -0,0 +1,86 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "../AI/AutoPlayer.h"
+#include "../Model/Game.h"
+#include "../Model/Random.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// A policy drives one Game at a time by choosing the next input. The batch
+// runner clones the prototype once per worker thread, so implementations
+// may keep mutable per-game state without locking.
+class Policy {
+public:
+    virtual ~Policy() = default;
+
+    virtual const char* getName() const = 0;
+    virtual std::unique_ptr<Policy> clone() const = 0;
+
+    // Called before every game with a seed derived from the game's seed
+    virtual void reset(uint64_t seed) = 0;
+    virtual InputAction chooseAction(const Game& game) = 0;
+
+    static std::unique_ptr<Policy> create(const std::string& name);
+    static std::vector<std::string> getNames();
+};
+
+// Uniformly random gameplay inputs
+class RandomPolicy : public Policy {
+public:
+    const char* getName() const override;
+    std::unique_ptr<Policy> clone() const override;
+    void reset(uint64_t seed) override;
+    InputAction chooseAction(const Game& game) override;
+
+private:
+    Random rng;
+};
+
+// Picks a random rotation and column for each piece, steers there and
+// hard-drops
+class RandomPlacementPolicy : public Policy {
+public:
+    RandomPlacementPolicy();
+
+    const char* getName() const override;
+    std::unique_ptr<Policy> clone() const override;
+    void reset(uint64_t seed) override;
+    InputAction chooseAction(const Game& game) override;
+
+private:
+    Random rng;
+    long long plannedPiece;
+    int rotationsLeft;
+    int targetX;
+    int lastX;
+};
+
+// Places every piece where the weighted board evaluator scores it best,
+// either among hard drops ("ai") or among every reachable lock position
+// ("ai-reachable")
+class AiPolicy : public Policy {
+public:
+    explicit AiPolicy(AutoPlayer::SearchMode mode = AutoPlayer::SearchMode::HARD_DROP);
+    // The autoplayer refers to this object's evaluator, so copies are
+    // made through clone() instead
+    AiPolicy(const AiPolicy&) = delete;
+    AiPolicy& operator=(const AiPolicy&) = delete;
+
+    // Clones share the same table, which must outlive them
+    void setTranspositionTable(TranspositionTable* table);
+
+    const char* getName() const override;
+    std::unique_ptr<Policy> clone() const override;
+    void reset(uint64_t seed) override;
+    InputAction chooseAction(const Game& game) override;
+
+private:
+    AutoPlayer::SearchMode mode;
+    TranspositionTable* table;
+    WeightedEvaluator evaluator;
+    AutoPlayer player;
+};
+
+#endif
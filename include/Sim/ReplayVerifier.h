@@ -0,0 +1,58 @@
+#ifndef REPLAY_VERIFIER_H
+#define REPLAY_VERIFIER_H
+
+#include "../Model/Replay.h"
+#include "WorkStealingPool.h"
+#include <string>
+#include <vector>
+
+// What playing one submitted replay back found
+struct ReplayVerdict {
+    std::string path;
+    bool accepted = false;
+    // Why it was rejected; empty when it was accepted
+    std::string reason;
+
+    // The outcome the file claims, and the one its inputs actually give
+    ReplaySummary claimed;
+    int score = 0;
+    int level = 1;
+    int linesCleared = 0;
+    long long piecesPlaced = 0;
+    long long events = 0;
+
+    // Where play first differed from the recording, as closely as the file
+    // can tell: the last recorded state the simulation still matched and
+    // the first one it did not, by session tick and by pieces locked in the
+    // session. Archives are compared at every keyframe, plain replays only
+    // at the start and the end. All -1 unless play diverged.
+    long long agreedTick = -1;
+    long long agreedPiece = -1;
+    long long divergedTick = -1;
+    long long divergedPiece = -1;
+};
+
+// Checks replays and replay archives by playing their inputs through a
+// headless Game, ticks applied straight to the engine with no clock or
+// rendering, and comparing the outcome with the one recorded: score, level,
+// lines, pieces and the digest of the final state. Files are memory-mapped
+// and spread across a WorkStealingPool one per task, so a long marathon
+// does not hold up the short games queued behind it.
+class ReplayVerifier {
+public:
+    // threadCount 0 means one worker per hardware thread
+    explicit ReplayVerifier(unsigned threadCount = 0);
+
+    unsigned getThreadCount() const;
+
+    // Verdicts come back in the order of `paths`
+    std::vector<ReplayVerdict> verify(const std::vector<std::string>& paths);
+
+    // One file, on the calling thread
+    static ReplayVerdict verifyFile(const std::string& path);
+
+private:
+    WorkStealingPool pool;
+};
+
+#endif
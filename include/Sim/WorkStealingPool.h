@@ -0,0 +1,57 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker pops
+// from the back of its own deque and, when that runs dry, steals from the
+// front of the others. Tasks receive the index of the worker running them so
+// they can use per-worker state without synchronisation.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(unsigned workerIndex)>;
+
+    // threadCount 0 means one worker per hardware thread
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned getThreadCount() const;
+
+    // From a worker thread the task goes onto that worker's own deque;
+    // from any other thread the deques are filled round-robin
+    void submit(Task task);
+    // Blocks until every submitted task has finished
+    void wait();
+
+private:
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> pending;
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+
+    void workerLoop(unsigned index);
+    bool tryTake(unsigned index, Task& task);
+};
+
+#endif
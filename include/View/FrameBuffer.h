@@ -0,0 +1,63 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Screen-sized grid of (glyph, style) cells that a frame is composed into
+// before anything is written to the terminal
+class FrameBuffer {
+public:
+    struct Cell {
+        uint32_t glyph;  // UTF-8 bytes packed low byte first, zero padded
+        uint8_t style;   // index into TerminalSink's SGR table, 0 = default
+
+        bool operator==(const Cell& other) const {
+            return glyph == other.glyph && style == other.style;
+        }
+        bool operator!=(const Cell& other) const {
+            return !(*this == other);
+        }
+    };
+
+    FrameBuffer(int width, int height);
+
+    // Packs a code point into the pre-encoded form stored in Cell::glyph
+    static constexpr uint32_t encode(char32_t codePoint) {
+        if (codePoint < 0x80) {
+            return codePoint;
+        }
+        if (codePoint < 0x800) {
+            return (0xC0u | (codePoint >> 6)) | ((0x80u | (codePoint & 0x3F)) << 8);
+        }
+        if (codePoint < 0x10000) {
+            return (0xE0u | (codePoint >> 12))
+                 | ((0x80u | ((codePoint >> 6) & 0x3F)) << 8)
+                 | ((0x80u | (codePoint & 0x3F)) << 16);
+        }
+        return (0xF0u | (codePoint >> 18))
+             | ((0x80u | ((codePoint >> 12) & 0x3F)) << 8)
+             | ((0x80u | ((codePoint >> 6) & 0x3F)) << 16)
+             | ((0x80u | (codePoint & 0x3F)) << 24);
+    }
+
+    int getWidth() const;
+    int getHeight() const;
+
+    void clear();
+    void put(int x, int y, uint32_t glyph, uint8_t style = 0);
+    // Writes UTF-8 text starting at (x, y); '\n' continues on the next row at x
+    void putText(int x, int y, const char* text, uint8_t style = 0);
+
+    const Cell& at(int x, int y) const {
+        return cells[static_cast<size_t>(y) * width + x];
+    }
+
+private:
+    int width;
+    int height;
+    std::vector<Cell> cells;
+};
+
+#endif
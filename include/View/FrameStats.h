@@ -0,0 +1,64 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Fixed-size log-linear histogram in the manner of HdrHistogram: values
+// below 64 get a bucket each, and every power of two above that is split
+// into 32 sub-buckets, so any recorded value is known to within about 3%.
+// Recording is a few shifts and an increment and never allocates.
+class Histogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values at or above this are recorded as MAX_VALUE - 1
+    static const int VALUE_BITS = 40;
+    static const uint64_t MAX_VALUE = 1ULL << VALUE_BITS;
+    static const int BUCKET_COUNT = (VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    Histogram();
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    // Upper edge of the bucket holding the value at `percentile` (0-100),
+    // capped at the largest value recorded; 0 when empty
+    uint64_t getPercentile(double percentile) const;
+
+    // Bucket i covers [getBucketLow(i), getBucketHigh(i)]
+    uint64_t getBucketCount(int index) const;
+    static uint64_t getBucketLow(int index);
+    static uint64_t getBucketHigh(int index);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts;
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+
+    static int indexOf(uint64_t value);
+};
+
+// What GameController measures while it runs: time spent in each phase of
+// a loop pass, output per presented frame, and how long each key took to
+// show up on screen. Times are in nanoseconds.
+struct FrameStats {
+    Histogram inputNanos;       // handleInput, for passes that had keys
+    Histogram updateNanos;      // autoplay and gravity, while playing
+    Histogram renderNanos;      // compose and present
+    Histogram frameBytes;       // bytes handed to the terminal per frame
+    Histogram keyLatencyNanos;  // key read to the frame showing it presented
+
+    void reset();
+    // Writes a summary and the non-empty buckets of every histogram
+    bool dump(const std::string& path, std::string& error) const;
+};
+
+#endif
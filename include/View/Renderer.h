@@ -2,35 +2,95 @@
 #define RENDERER_H
 
 #include "../Model/Game.h"
-#include <string>
+#include "FrameBuffer.h"
+#include "FrameStats.h"
+#include "TerminalSink.h"
 
+// Composes each screen into a back FrameBuffer, then presents only the cells
+// that differ from what is already on the terminal (the front buffer).
+// The game screens are templates over the board size; Renderer.cpp
+// instantiates them for every size BasicGame is.
 class Renderer {
 public:
+    // Upcoming pieces the sidebar has room for
+    static constexpr int MAX_PREVIEW_SHOWN = 6;
+
     Renderer();
+    // Writes frames to `fd`; -1 renders into a null sink, for benchmarks
+    explicit Renderer(int fd);
+    // A screen with room for a boardWidth x boardHeight playfield and its
+    // sidebar; the others fit the standard board
+    Renderer(int boardWidth, int boardHeight);
+    Renderer(int boardWidth, int boardHeight, int fd);
 
-    void render(const Game& game);
+    template <int W, int H>
+    void render(const BasicGame<W, H>& game);
     void renderMenu();
-    void renderGameOver(const Game& game);
-    void renderPaused(const Game& game);
+    template <int W, int H>
+    void renderGameOver(const BasicGame<W, H>& game);
+    template <int W, int H>
+    void renderPaused(const BasicGame<W, H>& game);
 
     void clearScreen();
     void setCursorPosition(int x, int y);
     void hideCursor();
     void showCursor();
 
+    // Output counters (bytes and syscalls per frame) for the last present
+    const TerminalSink& getSink() const;
+    // Collect frames in `outbox` rather than writing them; see
+    // TerminalSink::setOutbox
+    void setOutbox(std::vector<char>* outbox);
+    // Heap held by the frame buffers and the output staging buffer
+    size_t getMemoryBytes() const;
+
+    // Shows live percentiles from `stats` beside the sidebar in game
+    // frames; nullptr hides them. The stats must outlive the renderer.
+    void setStatsOverlay(const FrameStats* stats);
+
 private:
-    void renderBoard(const Game& game);
-    void renderCurrentPiece(const Game& game);
-    void renderGhostPiece(const Game& game);
-    void renderSidebar(const Game& game);
+    FrameBuffer back;
+    FrameBuffer front;
+    TerminalSink sink;
+    bool synchronizedOutput;
+    const FrameStats* statsOverlay;
+
+    template <int W, int H>
+    void composeGame(const BasicGame<W, H>& game);
+    template <int W, int H>
+    void renderBoard(const BasicGame<W, H>& game);
+    template <int W, int H>
+    void renderCurrentPiece(const BasicGame<W, H>& game);
+    template <int W, int H>
+    void renderGhostPiece(const BasicGame<W, H>& game);
+    template <int W, int H>
+    void renderSidebar(const BasicGame<W, H>& game);
     void renderNextPiece(const Tetromino& tetromino, int startX, int startY);
+    template <int W, int H>
+    void renderQueue(const BasicGame<W, H>& game, int startX, int startY);
+    void renderStats(int startX, int startY);
+    void putBlock(int screenX, int screenY, uint8_t style);
+
+    void present();
 
     char getCellChar(int value) const;
-    std::string getColorCode(int value) const;
+    static bool detectSynchronizedOutput();
     void resetColor();
 
     static const int BOARD_OFFSET_X = 2;
     static const int BOARD_OFFSET_Y = 1;
+    // Smallest screen; larger boards widen and deepen it
+    static const int SCREEN_WIDTH = 80;
+    static const int SCREEN_HEIGHT = 34;
+    static int screenWidthFor(int boardWidth);
+    static int screenHeightFor(int boardHeight);
+    // Left edge of the sidebar and of the stats overlay beside it
+    static int sidebarXFor(int boardWidth);
+    static int statsXFor(int boardWidth);
+    static const int STATS_Y = BOARD_OFFSET_Y + 22;
+    static const int STATS_WIDTH = 36;
+    static const int STATS_HEIGHT = 9;
+    static const int GAP_FILL_LIMIT = 3;
 };
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef TERMINAL_SINK_H
+#define TERMINAL_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Buffered terminal writer. It remembers where the cursor is and which SGR
+// style is active, drops moves and style changes that would not change
+// anything, picks the shortest escape for each cursor move, and hands the
+// whole frame to the OS in a single write.
+class TerminalSink {
+public:
+    // Styles 1-7 are the tetromino colours (TetrominoType + 1)
+    static const uint8_t STYLE_DEFAULT = 0;
+    static const uint8_t STYLE_GHOST = 8;
+    static const uint8_t STYLE_WHITE = 9;
+    static const uint8_t STYLE_COUNT = 10;
+
+    // fd -1 is a null sink: output is counted and discarded
+    explicit TerminalSink(int fd);
+
+    void moveTo(int x, int y);
+    void setStyle(uint8_t style);
+    // Writes one pre-encoded glyph (see FrameBuffer::encode) and advances
+    // the tracked cursor by one column
+    void putGlyph(uint32_t glyph);
+    // Raw bytes that neither move the cursor nor change the style, such as
+    // private mode switches
+    void putBytes(const char* bytes, size_t length);
+
+    // Forget the tracked cursor position, e.g. after the cursor may have
+    // hit the right margin; the next move is then absolute
+    void invalidateCursor();
+    // Clears the terminal and resets tracked state to (0, 0), default style
+    void clearScreen();
+
+    bool hasPendingOutput() const;
+    // Writes everything buffered since the last flush and records it as
+    // one frame in the counters
+    void flush();
+
+    // From now on flush() appends frames to `outbox` instead of writing
+    // them, for an owner that sends them itself (such as over a
+    // non-blocking socket); nullptr goes back to writing to the fd
+    void setOutbox(std::vector<char>* outbox);
+    // Bytes held by the staging buffer
+    size_t getCapacity() const;
+
+    size_t getLastFrameBytes() const;
+    unsigned getLastFrameSyscalls() const;
+    uint64_t getTotalBytes() const;
+    uint64_t getTotalSyscalls() const;
+    uint64_t getFrameCount() const;
+
+private:
+    int fd;
+    std::vector<char>* outbox;
+    std::vector<char> buffer;
+    size_t used;
+
+    int cursorX;
+    int cursorY;
+    int style;   // -1 = unknown
+
+    size_t lastFrameBytes;
+    unsigned lastFrameSyscalls;
+    uint64_t totalBytes;
+    uint64_t totalSyscalls;
+    uint64_t frameCount;
+
+    char* reserve(size_t length);
+    void appendCsi(int value, char final);
+    static const size_t OUTBOX_STAGING_SIZE = 2048;
+
+    static int countDigits(int value);
+    static char* writeNumber(char* out, int value);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "../../include/AI/AutoPlayer.h"
+
+AutoPlayer::AutoPlayer(const Evaluator& evaluator, SearchMode mode)
+    : search(evaluator)
+    , mode(mode)
+    , plannedPiece(-1)
+    , rotationsLeft(0)
+    , targetX(0)
+    , lastX(0)
+    , pathStep(0)
+    , searchCount(0)
+    , candidateCount(0) {
+}
+
+void AutoPlayer::reset() {
+    plannedPiece = -1;
+}
+
+void AutoPlayer::setTranspositionTable(TranspositionTable* table) {
+    search.setTranspositionTable(table);
+}
+
+InputAction AutoPlayer::chooseAction(const Game& game) {
+    if (game.getState() != GameState::PLAYING) {
+        return InputAction::NONE;
+    }
+
+    if (mode == SearchMode::REACHABLE) {
+        return followPath(game);
+    }
+
+    int x = game.getCurrentX();
+
+    if (game.getPiecesPlaced() != plannedPiece) {
+        plannedPiece = game.getPiecesPlaced();
+        Placement best;
+        if (search.findBest(game.getBoard(), game.getCurrentTetromino(), x, game.getCurrentY(), best)) {
+            rotationsLeft = best.rotations;
+            targetX = best.x;
+        } else {
+            rotationsLeft = 0;
+            targetX = x;
+        }
+        ++searchCount;
+        candidateCount += search.getLastCandidateCount();
+        lastX = x + 1; // anything but x, so the first move is not seen as blocked
+    }
+
+    if (rotationsLeft > 0) {
+        --rotationsLeft;
+        return InputAction::ROTATE_CW;
+    }
+
+    // A sideways move that left x unchanged hit the stack, e.g. after
+    // gravity pulled the piece below an overhang; settle for where it is
+    if (x == targetX || x == lastX) {
+        return InputAction::HARD_DROP;
+    }
+
+    lastX = x;
+    return x < targetX ? InputAction::MOVE_RIGHT : InputAction::MOVE_LEFT;
+}
+
+InputAction AutoPlayer::followPath(const Game& game) {
+    const Tetromino& piece = game.getCurrentTetromino();
+    int x = game.getCurrentX();
+    int y = game.getCurrentY();
+
+    bool onPath = game.getPiecesPlaced() == plannedPiece && pathStep < path.length;
+    if (onPath) {
+        const PathStep& step = path.steps[pathStep];
+        onPath = step.x == x && step.y == y && step.rotation == piece.getRotationState();
+    }
+
+    if (!onPath) {
+        plannedPiece = game.getPiecesPlaced();
+        pathStep = 0;
+        Placement best;
+        if (!search.findBestReachable(game.getBoard(), piece, x, y, best, path)) {
+            path.length = 0;
+        }
+        ++searchCount;
+        candidateCount += search.getLastCandidateCount();
+    }
+
+    if (pathStep >= path.length) {
+        return InputAction::HARD_DROP;
+    }
+    return path.steps[pathStep++].action;
+}
+
+long long AutoPlayer::getSearchCount() const {
+    return searchCount;
+}
+
+long long AutoPlayer::getCandidateCount() const {
+    return candidateCount;
+}
@@ -0,0 +1,52 @@
+#include "../../include/AI/Evaluator.h"
+#include <bitset>
+#include <cstdlib>
+
+const WeightedEvaluator::Weights WeightedEvaluator::DEFAULT_WEIGHTS = {
+    -0.510066,  // aggregate height
+     0.760666,  // lines cleared
+    -0.35663,   // holes
+    -0.184483   // bumpiness
+};
+
+const double WeightedEvaluator::TOP_OUT_PENALTY = -1e9;
+
+BoardFeatures BoardFeatures::measure(const Rows& rows, int linesCleared) {
+    BoardFeatures features;
+    features.linesCleared = linesCleared;
+    features.toppedOut = (rows[0] | rows[1]) != 0;
+
+    // Walk down from the top: a column's height is fixed by its first
+    // filled cell, and every empty cell below that is a hole
+    std::array<int, Board::WIDTH> heights{};
+    Board::Row covered = 0;
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        Board::Row row = rows[y];
+        Board::Row newlyCovered = row & ~covered;
+        for (int x = 0; newlyCovered != 0; ++x, newlyCovered >>= 1) {
+            if (newlyCovered & 1) heights[x] = Board::HEIGHT - y;
+        }
+        features.holes += static_cast<int>(std::bitset<Board::WIDTH>(covered & ~row).count());
+        covered |= row;
+    }
+
+    for (int x = 0; x < Board::WIDTH; ++x) {
+        features.aggregateHeight += heights[x];
+        if (heights[x] > features.maxHeight) features.maxHeight = heights[x];
+        if (x > 0) features.bumpiness += std::abs(heights[x] - heights[x - 1]);
+    }
+    return features;
+}
+
+WeightedEvaluator::WeightedEvaluator(const Weights& weights) : weights(weights) {
+}
+
+double WeightedEvaluator::evaluate(const BoardFeatures& features) const {
+    if (features.toppedOut) {
+        return TOP_OUT_PENALTY;
+    }
+    return weights.aggregateHeight * features.aggregateHeight +
+           weights.linesCleared * features.linesCleared +
+           weights.holes * features.holes +
+           weights.bumpiness * features.bumpiness;
+}
@@ -0,0 +1,213 @@
+#include "../../include/AI/MoveGenerator.h"
+#include "../../include/Model/Game.h"
+
+namespace {
+Tetromino makePiece(TetrominoType type, int rotation) {
+    Tetromino piece(type);
+    for (int i = 0; i < rotation; ++i) {
+        piece.rotate();
+    }
+    return piece;
+}
+
+// Row masks moved to the top-left corner of the matrix, so rotations that
+// cover the same cells compare equal
+std::array<uint8_t, Tetromino::MATRIX_SIZE> normalizedMasks(const Tetromino& piece) {
+    const auto& masks = piece.getRowMasks();
+    const PieceBounds& bounds = piece.getBounds();
+    std::array<uint8_t, Tetromino::MATRIX_SIZE> normalized{};
+    for (int row = bounds.minY; row <= bounds.maxY; ++row) {
+        normalized[row - bounds.minY] = static_cast<uint8_t>(masks[row] >> bounds.minX);
+    }
+    return normalized;
+}
+}
+
+MoveGenerator::MoveGenerator()
+    : nodeCount(0)
+    , lockCount(0)
+    , blockedKnown(0)
+    , pieceType(TetrominoType::NONE) {
+}
+
+int MoveGenerator::bitIndex(int rotation, int x) {
+    return rotation * X_SLOTS + x + X_OFFSET;
+}
+
+int MoveGenerator::canonicalRotation(TetrominoType type, int rotation) {
+    const auto masks = normalizedMasks(makePiece(type, rotation));
+    for (int earlier = 0; earlier < rotation; ++earlier) {
+        if (normalizedMasks(makePiece(type, earlier)) == masks) {
+            return earlier;
+        }
+    }
+    return rotation;
+}
+
+bool MoveGenerator::fits(int rotation, int x, int y) {
+    // Board::canPlace rejects these columns outright
+    if (x < -X_OFFSET || x >= Board::WIDTH) {
+        return false;
+    }
+
+    int index = bitIndex(rotation, x);
+    if (!(blockedKnown & (1ULL << index))) {
+        blocked[index] = computeBlocked(rotations[rotation], x);
+        blockedKnown |= 1ULL << index;
+    }
+    return !((blocked[index] >> y) & 1);
+}
+
+uint32_t MoveGenerator::computeBlocked(const Tetromino& piece, int x) const {
+    // Piece row k collides at y when board row y + k overlaps it, so OR
+    // together each row's overlap vector shifted down by k. Rows below the
+    // floor always collide.
+    const auto& masks = piece.getRowMasks();
+    uint32_t blockedRows = 0;
+    for (int k = 0; k < Tetromino::MATRIX_SIZE; ++k) {
+        if (masks[k] == 0) {
+            continue;
+        }
+        // Cells past either wall collide at every height
+        uint32_t shifted = x >= 0 ? static_cast<uint32_t>(masks[k]) << x : static_cast<uint32_t>(masks[k]) >> -x;
+        if (shifted & ~static_cast<uint32_t>(Board::FULL_ROW) || (x < 0 && (masks[k] & ((1u << -x) - 1)))) {
+            return ~0u;
+        }
+
+        uint32_t hits = ~0u << Board::HEIGHT;
+        for (int row = 0; row < Board::HEIGHT; ++row) {
+            hits |= static_cast<uint32_t>((rows[row] & shifted) != 0) << row;
+        }
+        blockedRows |= hits >> k | ~(~0u >> k);
+    }
+    return blockedRows;
+}
+
+bool MoveGenerator::rotateWithKicks(int& rotation, int& x, int y, bool clockwise) {
+    // Mirrors Game::rotateWithKicks on the cached masks
+    int turned = (rotation + (clockwise ? 1 : PIECE_ROTATIONS - 1)) % PIECE_ROTATIONS;
+    const int kickCount = Game::getKickCount(clockwise);
+    for (int i = 0; i < kickCount; ++i) {
+        if (fits(turned, x + Game::KICK_OFFSETS[i], y)) {
+            rotation = turned;
+            x += Game::KICK_OFFSETS[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MoveGenerator::visit(int rotation, int x, int y, InputAction action, int parent) {
+    uint64_t bit = 1ULL << bitIndex(rotation, x);
+    if (visited[y] & bit) {
+        return false;
+    }
+    visited[y] |= bit;
+
+    Node& node = nodes[nodeCount++];
+    node.x = static_cast<int8_t>(x);
+    node.y = static_cast<int8_t>(y);
+    node.rotation = static_cast<int8_t>(rotation);
+    node.action = action;
+    node.parent = static_cast<int16_t>(parent);
+    node.depth = static_cast<int16_t>(parent < 0 ? 0 : nodes[parent].depth + 1);
+    return true;
+}
+
+int MoveGenerator::generate(const Board& board, const Tetromino& piece, int x, int y) {
+    nodeCount = 0;
+    lockCount = 0;
+    visited.fill(0);
+    locked.fill(0);
+    blockedKnown = 0;
+    for (int row = 0; row < Board::HEIGHT; ++row) {
+        rows[row] = board.getRow(row);
+    }
+    pieceType = piece.getType();
+
+    std::array<int, PIECE_ROTATIONS> canonical;
+    for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+        rotations[rotation] = makePiece(pieceType, rotation);
+        canonical[rotation] = canonicalRotation(pieceType, rotation);
+    }
+
+    if (y < 0 || y >= Board::HEIGHT || !fits(piece.getRotationState(), x, y)) {
+        return 0;
+    }
+
+    visit(piece.getRotationState(), x, y, InputAction::NONE, -1);
+
+    // The node array doubles as the BFS queue: nodes are appended in the
+    // order they are discovered, hence in order of depth
+    for (int current = 0; current < nodeCount; ++current) {
+        const Node node = nodes[current];
+        const int rotation = node.rotation;
+
+        // A hard drop from here ends at the first blocked row below; the
+        // first node to reach a footprint has the shortest path to it
+        uint32_t below = blocked[bitIndex(rotation, node.x)] >> node.y;
+        int landing = node.y;
+        while (!(below & 2)) {
+            below >>= 1;
+            ++landing;
+        }
+
+        const PieceBounds& bounds = rotations[rotation].getBounds();
+        int anchorY = landing + bounds.minY;
+        uint64_t footprint = 1ULL << bitIndex(canonical[rotation], node.x + bounds.minX);
+        if (!(locked[anchorY] & footprint) && node.depth + 1 <= InputPath::MAX_LENGTH) {
+            locked[anchorY] |= footprint;
+            locks[lockCount++] = {rotations[rotation], node.x, landing, node.depth + 1, current};
+        }
+
+        if (fits(rotation, node.x - 1, node.y)) {
+            visit(rotation, node.x - 1, node.y, InputAction::MOVE_LEFT, current);
+        }
+        if (fits(rotation, node.x + 1, node.y)) {
+            visit(rotation, node.x + 1, node.y, InputAction::MOVE_RIGHT, current);
+        }
+        if (landing > node.y) {
+            visit(rotation, node.x, node.y + 1, InputAction::MOVE_DOWN, current);
+        }
+
+        int turned = rotation;
+        int turnedX = node.x;
+        if (rotateWithKicks(turned, turnedX, node.y, true)) {
+            visit(turned, turnedX, node.y, InputAction::ROTATE_CW, current);
+        }
+        turned = rotation;
+        turnedX = node.x;
+        if (rotateWithKicks(turned, turnedX, node.y, false)) {
+            visit(turned, turnedX, node.y, InputAction::ROTATE_CCW, current);
+        }
+    }
+
+    return lockCount;
+}
+
+int MoveGenerator::getCount() const {
+    return lockCount;
+}
+
+const LockPosition& MoveGenerator::get(int index) const {
+    return locks[index];
+}
+
+void MoveGenerator::getPath(int index, InputPath& path) const {
+    const LockPosition& lock = locks[index];
+    path.length = lock.pathLength;
+
+    const Node& last = nodes[lock.node];
+    path.steps[path.length - 1] = {InputAction::HARD_DROP, last.x, last.y, last.rotation};
+
+    // Walk back to the start; each node's action was applied to its parent
+    int step = path.length - 2;
+    for (int current = lock.node; nodes[current].parent >= 0; current = nodes[current].parent) {
+        const Node& parent = nodes[nodes[current].parent];
+        path.steps[step--] = {nodes[current].action, parent.x, parent.y, parent.rotation};
+    }
+}
+
+int MoveGenerator::getStatesVisited() const {
+    return nodeCount;
+}
@@ -0,0 +1,162 @@
+#include "../../include/AI/PlacementSearch.h"
+#include "../../include/Model/Game.h"
+
+PlacementSearch::PlacementSearch(const Evaluator& evaluator)
+    : evaluator(evaluator)
+    , table(nullptr)
+    , lastCandidateCount(0) {
+}
+
+void PlacementSearch::setTranspositionTable(TranspositionTable* newTable) {
+    table = newTable;
+}
+
+bool PlacementSearch::findBest(const Board& board, const Tetromino& piece, int x, int y, Placement& best) {
+    lastCandidateCount = 0;
+
+    uint64_t key = 0;
+    if (table) {
+        key = TranspositionTable::makeKey(board, piece, x, y);
+        TableEntry entry;
+        if (table->probe(key, entry) && entry.depth >= 1) {
+            best.rotations = entry.rotations;
+            best.x = entry.x;
+            best.y = entry.y;
+            best.linesCleared = entry.linesCleared;
+            best.score = entry.score;
+            return true;
+        }
+    }
+
+    BoardFeatures::Rows rows;
+    for (int row = 0; row < Board::HEIGHT; ++row) {
+        rows[row] = board.getRow(row);
+    }
+
+    bool found = false;
+
+    Tetromino rotated = piece;
+    int rotatedX = x;
+    std::array<uint8_t, Tetromino::MATRIX_SIZE> seenMasks[PIECE_ROTATIONS];
+
+    for (int rotations = 0; rotations < PIECE_ROTATIONS; ++rotations) {
+        if (rotations > 0 && !Game::rotateWithKicks(board, rotated, rotatedX, y, true)) {
+            // Blocked: further turns would need this one first
+            break;
+        }
+
+        if (rotations == 0 && !board.canPlace(rotated, rotatedX, y)) {
+            break;
+        }
+
+        // Symmetric pieces repeat shapes; the same shape reaches the same
+        // placements, since sideways moves cover every reachable column
+        const auto& masks = rotated.getRowMasks();
+        seenMasks[rotations] = masks;
+        bool repeated = false;
+        for (int earlier = 0; earlier < rotations && !repeated; ++earlier) {
+            repeated = seenMasks[earlier] == masks;
+        }
+        if (repeated) {
+            continue;
+        }
+
+        int left = rotatedX;
+        while (board.canPlace(rotated, left - 1, y)) --left;
+        int right = rotatedX;
+        while (board.canPlace(rotated, right + 1, y)) ++right;
+
+        for (int column = left; column <= right; ++column) {
+            int landing = board.getLandingY(rotated, column, y);
+
+            int lines;
+            double score = scorePlacement(rows, masks, column, landing, lines);
+            if (!found || score > best.score) {
+                best.rotations = rotations;
+                best.x = column;
+                best.y = landing;
+                best.linesCleared = lines;
+                best.score = score;
+                found = true;
+            }
+        }
+    }
+
+    if (found && table) {
+        TableEntry entry;
+        entry.score = static_cast<float>(best.score);
+        entry.depth = 1;
+        entry.rotations = best.rotations;
+        entry.x = best.x;
+        entry.y = best.y;
+        entry.linesCleared = best.linesCleared;
+        table->store(key, entry);
+    }
+    return found;
+}
+
+bool PlacementSearch::findBestReachable(const Board& board, const Tetromino& piece, int x, int y,
+                                        Placement& best, InputPath& path) {
+    BoardFeatures::Rows rows;
+    for (int row = 0; row < Board::HEIGHT; ++row) {
+        rows[row] = board.getRow(row);
+    }
+
+    lastCandidateCount = 0;
+    int bestIndex = -1;
+    int count = moves.generate(board, piece, x, y);
+
+    for (int i = 0; i < count; ++i) {
+        const LockPosition& lock = moves.get(i);
+        int lines;
+        double score = scorePlacement(rows, lock.piece.getRowMasks(), lock.x, lock.y, lines);
+        // Between equal scores, prefer the one with fewer inputs
+        if (bestIndex < 0 || score > best.score ||
+            (score == best.score && lock.pathLength < moves.get(bestIndex).pathLength)) {
+            bestIndex = i;
+            best.rotations = (lock.piece.getRotationState() - piece.getRotationState() + PIECE_ROTATIONS) % PIECE_ROTATIONS;
+            best.x = lock.x;
+            best.y = lock.y;
+            best.linesCleared = lines;
+            best.score = score;
+        }
+    }
+
+    if (bestIndex < 0) {
+        return false;
+    }
+    moves.getPath(bestIndex, path);
+    return true;
+}
+
+double PlacementSearch::scorePlacement(const BoardFeatures::Rows& rows,
+                                       const std::array<uint8_t, Tetromino::MATRIX_SIZE>& masks,
+                                       int x, int y, int& linesCleared) {
+    // Lock into a copy of the rows and remove full ones in place
+    BoardFeatures::Rows after = rows;
+    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+        int boardY = y + row;
+        if (masks[row] != 0 && boardY >= 0 && boardY < Board::HEIGHT) {
+            uint32_t bits = x >= 0 ? static_cast<uint32_t>(masks[row]) << x
+                                   : static_cast<uint32_t>(masks[row]) >> -x;
+            after[boardY] = static_cast<Board::Row>(after[boardY] | (bits & Board::FULL_ROW));
+        }
+    }
+    int write = Board::HEIGHT - 1;
+    for (int row = Board::HEIGHT - 1; row >= 0; --row) {
+        if (after[row] != Board::FULL_ROW) {
+            after[write--] = after[row];
+        }
+    }
+    linesCleared = write + 1;
+    for (; write >= 0; --write) {
+        after[write] = 0;
+    }
+
+    ++lastCandidateCount;
+    return evaluator.evaluate(BoardFeatures::measure(after, linesCleared));
+}
+
+int PlacementSearch::getLastCandidateCount() const {
+    return lastCandidateCount;
+}
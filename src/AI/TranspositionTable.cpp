@@ -0,0 +1,163 @@
+#include "../../include/AI/TranspositionTable.h"
+#include "../../include/Model/Random.h"
+#include <array>
+#include <cstring>
+
+namespace {
+// Keys for the piece (type and rotation) and its x and y, drawn from a
+// different stream than Board's cell keys
+struct PieceKeys {
+    std::array<std::array<uint64_t, PIECE_ROTATIONS>, PIECE_TYPES + 1> shape;
+    std::array<uint64_t, 32> x;
+    std::array<uint64_t, 32> y;
+};
+
+constexpr PieceKeys makePieceKeys() {
+    PieceKeys keys{};
+    uint64_t state = 0xC3A5C85C97CB3127ULL;
+    for (auto& rotations : keys.shape) {
+        for (auto& key : rotations) {
+            key = Random::splitMix64(state);
+        }
+    }
+    for (auto& key : keys.x) key = Random::splitMix64(state);
+    for (auto& key : keys.y) key = Random::splitMix64(state);
+    return keys;
+}
+
+constexpr PieceKeys PIECE_KEYS = makePieceKeys();
+
+// x and y are offset so the few positions above or left of the board
+// still get their own keys
+constexpr int POSITION_OFFSET = Tetromino::MATRIX_SIZE;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    size_t count = megabytes * 1024 * 1024 / sizeof(Bucket);
+    size_t power = 1;
+    while (power * 2 <= count) {
+        power *= 2;
+    }
+    // Value-initialised, so every slot starts empty
+    buckets.reset(new Bucket[power]());
+    mask = power - 1;
+}
+
+uint64_t TranspositionTable::makeKey(const Board& board, const Tetromino& piece, int x, int y) {
+    return board.getHash()
+         ^ PIECE_KEYS.shape[static_cast<int>(piece.getType())][piece.getRotationState()]
+         ^ PIECE_KEYS.x[(x + POSITION_OFFSET) & 31]
+         ^ PIECE_KEYS.y[(y + POSITION_OFFSET) & 31];
+}
+
+uint64_t TranspositionTable::pack(const TableEntry& entry) {
+    uint32_t scoreBits;
+    std::memcpy(&scoreBits, &entry.score, sizeof(scoreBits));
+    // x is offset by 8, so a stored entry is never all zero bits
+    return static_cast<uint64_t>(scoreBits)
+         | static_cast<uint64_t>(entry.depth & 0xFF) << 32
+         | static_cast<uint64_t>((entry.rotations & 0x3) | (entry.linesCleared & 0x7) << 2) << 40
+         | static_cast<uint64_t>((entry.x + 8) & 0xFF) << 48
+         | static_cast<uint64_t>((entry.y + 8) & 0xFF) << 56;
+}
+
+TableEntry TranspositionTable::unpack(uint64_t data) {
+    TableEntry entry;
+    uint32_t scoreBits = static_cast<uint32_t>(data);
+    std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+    entry.depth = static_cast<int>((data >> 32) & 0xFF);
+    entry.rotations = static_cast<int>((data >> 40) & 0x3);
+    entry.linesCleared = static_cast<int>((data >> 42) & 0x7);
+    entry.x = static_cast<int>((data >> 48) & 0xFF) - 8;
+    entry.y = static_cast<int>((data >> 56) & 0xFF) - 8;
+    return entry;
+}
+
+uint64_t TranspositionTable::read(const Slot& slot, uint64_t key) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    return data != 0 && (check ^ data) == key ? data : 0;
+}
+
+bool TranspositionTable::isOccupied(const Slot& slot) {
+    return slot.data.load(std::memory_order_relaxed) != 0;
+}
+
+void TranspositionTable::write(Slot& slot, uint64_t key, uint64_t data) {
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TableEntry& entry) {
+    probes.value.fetch_add(1, std::memory_order_relaxed);
+
+    const Bucket& bucket = buckets[key & mask];
+    uint64_t data = read(bucket.deepest, key);
+    if (data == 0) {
+        data = read(bucket.newest, key);
+    }
+    if (data == 0) {
+        if (isOccupied(bucket.deepest) || isOccupied(bucket.newest)) {
+            collisions.value.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    hits.value.fetch_add(1, std::memory_order_relaxed);
+    entry = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, const TableEntry& entry) {
+    stores.value.fetch_add(1, std::memory_order_relaxed);
+
+    Bucket& bucket = buckets[key & mask];
+    const uint64_t data = pack(entry);
+
+    // The deep slot keeps its position unless this search went at least as
+    // deep, or it is the same position being refreshed
+    uint64_t deepData = bucket.deepest.data.load(std::memory_order_relaxed);
+    bool samePosition = read(bucket.deepest, key) != 0;
+    if (deepData == 0 || samePosition || entry.depth >= unpack(deepData).depth) {
+        if (deepData != 0 && !samePosition) {
+            replacements.value.fetch_add(1, std::memory_order_relaxed);
+        }
+        write(bucket.deepest, key, data);
+        return;
+    }
+
+    if (isOccupied(bucket.newest) && read(bucket.newest, key) == 0) {
+        replacements.value.fetch_add(1, std::memory_order_relaxed);
+    }
+    write(bucket.newest, key, data);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        write(buckets[i].deepest, 0, 0);
+        write(buckets[i].newest, 0, 0);
+    }
+    probes.value.store(0);
+    hits.value.store(0);
+    collisions.value.store(0);
+    stores.value.store(0);
+    replacements.value.store(0);
+}
+
+size_t TranspositionTable::getBucketCount() const {
+    return mask + 1;
+}
+
+size_t TranspositionTable::getSizeBytes() const {
+    return getBucketCount() * sizeof(Bucket);
+}
+
+TableStats TranspositionTable::getStats() const {
+    TableStats stats;
+    stats.probes = probes.value.load(std::memory_order_relaxed);
+    stats.hits = hits.value.load(std::memory_order_relaxed);
+    stats.collisions = collisions.value.load(std::memory_order_relaxed);
+    stats.stores = stores.value.load(std::memory_order_relaxed);
+    stats.replacements = replacements.value.load(std::memory_order_relaxed);
+    return stats;
+}
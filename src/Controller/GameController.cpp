@@ -1,5 +1,5 @@
 #include "../../include/Controller/GameController.h"
-#include <thread>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -7,65 +7,271 @@
 #include <unistd.h>
 #endif
 
-GameController::GameController()
-    : running(false)
-    , lastDropTime(std::chrono::steady_clock::now())
-    , lastRenderTime(std::chrono::steady_clock::now()) {
+using Clock = std::chrono::steady_clock;
+
+void WakeupStats::record(Clock::duration lateness) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(lateness);
+    if (micros.count() < 0) micros = std::chrono::microseconds(0);
+    ++timerWakeups;
+    totalLateness += micros;
+    maxLateness = std::max(maxLateness, micros);
+}
+
+template <int W, int H>
+BasicGameController<W, H>::BasicGameController()
+    : renderer(W, H)
+    , running(false)
+    , needsRender(true)
+    , lastTickTime(Clock::now())
+    , lastRenderTime(Clock::now() - FRAME_DURATION)
+    , statsVisible(false)
+    , pendingKeyCount(0) {
 }
 
-GameController::~GameController() {
+static uint64_t elapsedNanos(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+template <int W, int H>
+BasicGameController<W, H>::~BasicGameController() {
     renderer.showCursor();
     renderer.clearScreen();
 }
 
-void GameController::run() {
+template <int W, int H>
+void BasicGameController<W, H>::run() {
     running = true;
     renderer.clearScreen();
     renderer.renderMenu();
+    needsRender = false;
 
     while (running) {
-        handleInput();
+        // Sleep until a key arrives or the earliest of the next gravity step
+        // and the next frame slot (if a frame is owed); nothing is due on
+        // the menu, pause or game-over screens, so those wait on input alone
+        auto deadline = nextDeadline();
+        if (inputHandler.waitForEvent(deadline)) {
+            ++wakeupStats.inputWakeups;
+        } else if (deadline != Clock::time_point::max()) {
+            wakeupStats.record(Clock::now() - deadline);
+        }
+
+        auto phaseStart = Clock::now();
+        int keys = handleInput();
+        auto phaseEnd = Clock::now();
+        if (keys > 0) {
+            frameStats.inputNanos.record(elapsedNanos(phaseStart, phaseEnd));
+        }
+        if (inputHandler.isClosed() && !inputHandler.isKeyPressed()) {
+            running = false;
+        }
 
         if (game.getState() == GameState::PLAYING) {
+            phaseStart = phaseEnd;
+            autoPlay();
             update();
+            phaseEnd = Clock::now();
+            frameStats.updateNanos.record(elapsedNanos(phaseStart, phaseEnd));
         }
 
-        render();
+        // Frames are paced to TARGET_FPS; changes that land inside a frame
+        // slot are folded into the next frame
+        auto now = phaseEnd;
+        if (needsRender && now - lastRenderTime >= FRAME_DURATION) {
+            uint64_t framesBefore = renderer.getSink().getFrameCount();
+            render();
+            auto presented = Clock::now();
+            frameStats.renderNanos.record(elapsedNanos(now, presented));
+            if (renderer.getSink().getFrameCount() != framesBefore) {
+                frameStats.frameBytes.record(renderer.getSink().getLastFrameBytes());
+            }
+            for (int i = 0; i < pendingKeyCount; ++i) {
+                frameStats.keyLatencyNanos.record(elapsedNanos(pendingKeys[i], presented));
+            }
+            pendingKeyCount = 0;
+            lastRenderTime = now;
+            needsRender = false;
+        }
+    }
+}
 
-        // Frame rate limiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
+template <int W, int H>
+Clock::time_point BasicGameController<W, H>::nextDeadline() const {
+    auto deadline = Clock::time_point::max();
+    if (game.getState() == GameState::PLAYING) {
+        deadline = lastTickTime + std::chrono::milliseconds(game.getTicksUntilDrop());
     }
+    if (autoPlayer && game.getState() == GameState::PLAYING) {
+        deadline = std::min(deadline, nextAutoMoveTime);
+    }
+    if (needsRender) {
+        deadline = std::min(deadline, lastRenderTime + FRAME_DURATION);
+    }
+    return deadline;
 }
 
-void GameController::handleInput() {
-    InputAction action = inputHandler.getInput();
+template <int W, int H>
+void BasicGameController<W, H>::runReplay(const Replay& replay) {
+    if constexpr (IS_STANDARD) {
+        ReplayPlayer player(replay, game);
 
-    if (action == InputAction::NONE) {
-        return;
+        running = true;
+        renderer.clearScreen();
+        GameState shownState = game.getState();
+        bool finalFrameShown = false;
+        const auto start = Clock::now();
+
+        while (running) {
+            // Session ticks only advance while playing, so paused stretches of
+            // the recording play back instantly
+            auto now = Clock::now();
+            player.advanceTo(std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+            if (game.getState() != shownState) {
+                renderer.clearScreen();
+                shownState = game.getState();
+            }
+            if (now - lastRenderTime >= FRAME_DURATION) {
+                render();
+                lastRenderTime = now;
+                finalFrameShown = player.isFinished();
+            }
+
+            // Wake for the next event or gravity step, never faster than the
+            // frame rate; once the last frame is up, only input matters
+            auto deadline = Clock::time_point::max();
+            if (!finalFrameShown) {
+                long long due = player.getNextEventTick();
+                if (game.getState() == GameState::PLAYING) {
+                    due = std::min(due, player.getTick() + game.getTicksUntilDrop());
+                }
+                deadline = std::max(start + std::chrono::milliseconds(due), lastRenderTime + FRAME_DURATION);
+            }
+            inputHandler.waitForEvent(deadline);
+
+            KeyEvent event;
+            while (inputHandler.pollEvent(event)) {
+                if (event.action == InputAction::QUIT) {
+                    running = false;
+                }
+            }
+            if (inputHandler.isClosed()) {
+                running = false;
+            }
+        }
     }
+}
 
-    switch (game.getState()) {
-        case GameState::MENU:
-            handleMenuInput(action);
-            break;
-        case GameState::PLAYING:
-            handlePlayingInput(action);
-            break;
-        case GameState::PAUSED:
-            handlePausedInput(action);
-            break;
-        case GameState::GAME_OVER:
-            handleGameOverInput(action);
-            break;
+template <int W, int H>
+void BasicGameController<W, H>::setPiecePolicy(PiecePolicy policy) {
+    game.setPiecePolicy(policy);
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::setPreviewDepth(int depth) {
+    game.setPreviewDepth(depth);
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::enableAutoPlay() {
+    if constexpr (IS_STANDARD) {
+        autoPlayer.reset(new AutoPlayer(evaluator, AutoPlayer::SearchMode::REACHABLE));
+        nextAutoMoveTime = Clock::now();
     }
 }
 
-void GameController::handleMenuInput(InputAction action) {
+template <int W, int H>
+void BasicGameController<W, H>::startRecording() {
+    if constexpr (IS_STANDARD) {
+        recorder.reset(new ReplayRecorder(game.getSeed(), game.getPiecePolicy()));
+    }
+}
+
+template <int W, int H>
+bool BasicGameController<W, H>::saveRecording(const std::string& path, std::string& error) const {
+    if (!recorder) {
+        error = "nothing was recorded";
+        return false;
+    }
+    if constexpr (IS_STANDARD) {
+        return recorder->save(path, game, error);
+    } else {
+        return false;
+    }
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::startArchiving(int keyframeInterval) {
+    if constexpr (IS_STANDARD) {
+        archiveWriter.reset(new ReplayArchiveWriter(game, keyframeInterval));
+    }
+}
+
+template <int W, int H>
+bool BasicGameController<W, H>::saveArchive(const std::string& path, std::string& error) const {
+    if (!archiveWriter) {
+        error = "nothing was recorded";
+        return false;
+    }
+    return archiveWriter->save(path, error);
+}
+
+template <int W, int H>
+const WakeupStats& BasicGameController<W, H>::getWakeupStats() const {
+    return wakeupStats;
+}
+
+template <int W, int H>
+const FrameStats& BasicGameController<W, H>::getFrameStats() const {
+    return frameStats;
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::toggleStats() {
+    statsVisible = !statsVisible;
+    renderer.setStatsOverlay(statsVisible ? &frameStats : nullptr);
+}
+
+template <int W, int H>
+int BasicGameController<W, H>::handleInput() {
+    // Drain every key the reader thread queued since the last frame, in
+    // order, so fast sequences are neither delayed nor lost
+    int handled = 0;
+    KeyEvent event;
+    while (running && inputHandler.pollEvent(event)) {
+        ++handled;
+        needsRender = true;
+        if (pendingKeyCount < static_cast<int>(pendingKeys.size())) {
+            pendingKeys[pendingKeyCount++] = event.timestamp;
+        }
+        if (event.action == InputAction::TOGGLE_STATS) {
+            toggleStats();
+            continue;
+        }
+        switch (game.getState()) {
+            case GameState::MENU:
+                handleMenuInput(event.action);
+                break;
+            case GameState::PLAYING:
+                handlePlayingInput(event.action);
+                break;
+            case GameState::PAUSED:
+                handlePausedInput(event.action);
+                break;
+            case GameState::GAME_OVER:
+                handleGameOverInput(event.action);
+                break;
+        }
+    }
+    return handled;
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::handleMenuInput(InputAction action) {
     switch (action) {
         case InputAction::START:
-            game.start();
+            applyAction(action);
             renderer.clearScreen();
-            resetDropTimer();
+            resetTickClock();
             break;
         case InputAction::QUIT:
             running = false;
@@ -75,45 +281,25 @@ void GameController::handleMenuInput(InputAction action) {
     }
 }
 
-void GameController::handlePlayingInput(InputAction action) {
+template <int W, int H>
+void BasicGameController<W, H>::handlePlayingInput(InputAction action) {
     switch (action) {
-        case InputAction::MOVE_LEFT:
-            game.moveLeft();
-            break;
-        case InputAction::MOVE_RIGHT:
-            game.moveRight();
-            break;
-        case InputAction::MOVE_DOWN:
-            if (game.moveDown()) {
-                resetDropTimer();
-            }
-            break;
-        case InputAction::HARD_DROP:
-            game.hardDrop();
-            resetDropTimer();
-            break;
-        case InputAction::ROTATE_CW:
-            game.rotate();
-            break;
-        case InputAction::ROTATE_CCW:
-            game.rotateCounterClockwise();
-            break;
-        case InputAction::PAUSE:
-            game.pause();
-            break;
         case InputAction::QUIT:
             running = false;
             break;
         default:
+            applyAction(action);
             break;
     }
 }
 
-void GameController::handlePausedInput(InputAction action) {
+template <int W, int H>
+void BasicGameController<W, H>::handlePausedInput(InputAction action) {
     switch (action) {
         case InputAction::PAUSE:
-            game.resume();
+            applyAction(action);
             renderer.clearScreen();
+            resetTickClock();
             break;
         case InputAction::QUIT:
             running = false;
@@ -123,12 +309,13 @@ void GameController::handlePausedInput(InputAction action) {
     }
 }
 
-void GameController::handleGameOverInput(InputAction action) {
+template <int W, int H>
+void BasicGameController<W, H>::handleGameOverInput(InputAction action) {
     switch (action) {
         case InputAction::RESTART:
-            game.start();
+            applyAction(action);
             renderer.clearScreen();
-            resetDropTimer();
+            resetTickClock();
             break;
         case InputAction::QUIT:
             running = false;
@@ -138,14 +325,58 @@ void GameController::handleGameOverInput(InputAction action) {
     }
 }
 
-void GameController::update() {
-    if (shouldDrop()) {
-        game.update();
-        resetDropTimer();
+template <int W, int H>
+void BasicGameController<W, H>::update() {
+    // Convert wall-clock time into whole engine ticks, carrying the
+    // remainder so no time is lost between frames
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTickTime);
+    if (elapsed.count() > 0) {
+        // Only a gravity step changes what is on screen
+        if (elapsed.count() >= game.getTicksUntilDrop()) {
+            needsRender = true;
+        }
+        game.advance(static_cast<int>(elapsed.count()));
+        if (recorder) {
+            recorder->advance(static_cast<int>(elapsed.count()));
+        }
+        if (archiveWriter) {
+            archiveWriter->advance(static_cast<int>(elapsed.count()));
+        }
+        lastTickTime += elapsed;
     }
 }
 
-void GameController::render() {
+template <int W, int H>
+void BasicGameController<W, H>::autoPlay() {
+    auto now = Clock::now();
+    if (!autoPlayer || now < nextAutoMoveTime) {
+        return;
+    }
+    nextAutoMoveTime = now + AUTO_MOVE_INTERVAL;
+
+    if constexpr (IS_STANDARD) {
+        InputAction action = autoPlayer->chooseAction(game);
+        if (action != InputAction::NONE) {
+            applyAction(action);
+            needsRender = true;
+        }
+    }
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::applyAction(InputAction action) {
+    game.applyAction(action);
+    if (recorder) {
+        recorder->record(action);
+    }
+    if (archiveWriter) {
+        archiveWriter->record(action);
+    }
+}
+
+template <int W, int H>
+void BasicGameController<W, H>::render() {
     switch (game.getState()) {
         case GameState::MENU:
             // Menu is rendered once when entering, no need to re-render
@@ -154,7 +385,6 @@ void GameController::render() {
             renderer.render(game);
             break;
         case GameState::PAUSED:
-            renderer.render(game);
             renderer.renderPaused(game);
             break;
         case GameState::GAME_OVER:
@@ -163,12 +393,12 @@ void GameController::render() {
     }
 }
 
-bool GameController::shouldDrop() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastDropTime);
-    return elapsed.count() >= game.getDropInterval();
+template <int W, int H>
+void BasicGameController<W, H>::resetTickClock() {
+    lastTickTime = std::chrono::steady_clock::now();
 }
 
-void GameController::resetDropTimer() {
-    lastDropTime = std::chrono::steady_clock::now();
-}
+template class BasicGameController<10, 20>;
+template class BasicGameController<10, 40>;
+template class BasicGameController<16, 20>;
+template class BasicGameController<32, 20>;
@@ -1,16 +1,74 @@
 #include "../../include/Controller/InputHandler.h"
+#include "../../include/Controller/KeyDecoder.h"
 
 #ifdef _WIN32
 #include <conio.h>
 #include <windows.h>
 #else
-#include <termios.h>
-#include <unistd.h>
+#include <cerrno>
+#include <csignal>
 #include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+// Copy of the terminal settings for the signal handler, which must not
+// touch the InputHandler itself
+struct termios signalRestoreTermios;
+volatile sig_atomic_t signalRestoreArmed = 0;
+
+void restoreTerminalOnSignal(int signalNumber) {
+    if (signalRestoreArmed) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &signalRestoreTermios);
+    }
+    signal(signalNumber, SIG_DFL);
+    raise(signalNumber);
+}
+
+// How long a lone ESC waits for the rest of an escape sequence
+const int ESCAPE_TIMEOUT_MS = 25;
+}
 #endif
 
-InputHandler::InputHandler() {
+InputHandler::InputHandler()
+    : stopping(false)
+    , droppedEvents(0)
+    , closed(false)
+#ifndef _WIN32
+    , termiosSaved(false)
+#endif
+{
+#ifndef _WIN32
+    wakePipe[0] = -1;
+    wakePipe[1] = -1;
+    if (pipe(wakePipe) == 0) {
+        fcntl(wakePipe[1], F_SETFL, fcntl(wakePipe[1], F_GETFL, 0) | O_NONBLOCK);
+    }
+#endif
     setupConsole();
+    reader = std::thread(&InputHandler::readerLoop, this);
+}
+
+InputHandler::~InputHandler() {
+    stopping.store(true);
+#ifndef _WIN32
+    if (wakePipe[1] >= 0) {
+        char byte = 0;
+        ssize_t ignored = write(wakePipe[1], &byte, 1);
+        (void)ignored;
+    }
+#endif
+    if (reader.joinable()) {
+        reader.join();
+    }
+    restoreConsole();
+#ifndef _WIN32
+    for (int fd : wakePipe) {
+        if (fd >= 0) close(fd);
+    }
+#endif
 }
 
 void InputHandler::setupConsole() {
@@ -21,123 +79,167 @@ void InputHandler::setupConsole() {
     GetConsoleMode(hOut, &dwMode);
     dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
     SetConsoleMode(hOut, dwMode);
+#else
+    // Unbuffered, no echo, for the whole session
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &originalTermios) != 0) {
+        return;
+    }
+    termiosSaved = true;
+
+    signalRestoreTermios = originalTermios;
+    signalRestoreArmed = 1;
+    signal(SIGINT, restoreTerminalOnSignal);
+    signal(SIGTERM, restoreTerminalOnSignal);
+
+    struct termios raw = originalTermios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
 #endif
 }
 
 void InputHandler::restoreConsole() {
+#ifndef _WIN32
+    if (termiosSaved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &originalTermios);
+        signalRestoreArmed = 0;
+        termiosSaved = false;
+    }
+#endif
     // Nothing to restore on Windows
 }
 
+bool InputHandler::pollEvent(KeyEvent& event) {
+    return events.pop(event);
+}
+
 bool InputHandler::isKeyPressed() {
-#ifdef _WIN32
-    return _kbhit() != 0;
-#else
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
+    return !events.empty();
+}
 
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+bool InputHandler::waitForEvent(std::chrono::steady_clock::time_point deadline) {
+    auto ready = [this] { return !events.empty() || closed.load(); };
 
-    ch = getchar();
+    std::unique_lock<std::mutex> lock(doorbellMutex);
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        doorbell.wait(lock, ready);
+    } else {
+        doorbell.wait_until(lock, deadline, ready);
+    }
+    return !events.empty();
+}
 
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
+bool InputHandler::isClosed() const {
+    return closed.load();
+}
 
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return true;
-    }
-    return false;
-#endif
+void InputHandler::ringDoorbell() {
+    // Taking the lock orders the notify after a waiter's predicate check
+    { std::lock_guard<std::mutex> lock(doorbellMutex); }
+    doorbell.notify_one();
 }
 
-InputAction InputHandler::getInput() {
-    if (!isKeyPressed()) {
-        return InputAction::NONE;
+uint64_t InputHandler::getDroppedEvents() const {
+    return droppedEvents.load(std::memory_order_relaxed);
+}
+
+void InputHandler::pushAction(InputAction action, std::chrono::steady_clock::time_point timestamp) {
+    if (action == InputAction::NONE) {
+        return;
     }
+    if (!events.push({action, timestamp})) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
 #ifdef _WIN32
-    int ch = _getch();
-
-    // Handle special keys (arrows, function keys)
-    if (ch == 0 || ch == 224) {
-        ch = _getch();
-        switch (ch) {
-            case 72: return InputAction::ROTATE_CW;      // Up arrow
-            case 80: return InputAction::MOVE_DOWN;      // Down arrow
-            case 75: return InputAction::MOVE_LEFT;      // Left arrow
-            case 77: return InputAction::MOVE_RIGHT;     // Right arrow
-            default: return InputAction::NONE;
+
+void InputHandler::readerLoop() {
+    HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+
+    while (!stopping.load()) {
+        // Wake periodically so shutdown is noticed
+        if (WaitForSingleObject(input, 50) != WAIT_OBJECT_0) {
+            continue;
         }
-    }
+        if (!_kbhit()) {
+            // Signalled by a non-key console event (focus, mouse, resize)
+            Sleep(1);
+            continue;
+        }
+
+        while (_kbhit()) {
+            int ch = _getch();
+            auto now = std::chrono::steady_clock::now();
+
+            // Handle special keys (arrows, function keys)
+            if (ch == 0 || ch == 224) {
+                switch (_getch()) {
+                    case 72: pushAction(InputAction::ROTATE_CW, now); break;   // Up arrow
+                    case 80: pushAction(InputAction::MOVE_DOWN, now); break;   // Down arrow
+                    case 75: pushAction(InputAction::MOVE_LEFT, now); break;   // Left arrow
+                    case 77: pushAction(InputAction::MOVE_RIGHT, now); break;  // Right arrow
+                    default: break;
+                }
+                continue;
+            }
 
-    // Handle regular keys
-    switch (ch) {
-        case ' ':  return InputAction::HARD_DROP;
-        case 13:   return InputAction::START;            // Enter
-        case 'z':
-        case 'Z':  return InputAction::ROTATE_CW;
-        case 'x':
-        case 'X':  return InputAction::ROTATE_CCW;
-        case 'p':
-        case 'P':  return InputAction::PAUSE;
-        case 'q':
-        case 'Q':  return InputAction::QUIT;
-        case 'r':
-        case 'R':  return InputAction::RESTART;
-        case 'w':
-        case 'W':  return InputAction::ROTATE_CW;
-        case 's':
-        case 'S':  return InputAction::MOVE_DOWN;
-        case 'a':
-        case 'A':  return InputAction::MOVE_LEFT;
-        case 'd':
-        case 'D':  return InputAction::MOVE_RIGHT;
-        default:   return InputAction::NONE;
+            pushAction(KeyDecoder::mapKey(ch), now);
+        }
+        ringDoorbell();
     }
+}
+
 #else
-    int ch = getchar();
-
-    // Handle escape sequences (arrow keys)
-    if (ch == 27) {
-        if (getchar() == '[') {
-            switch (getchar()) {
-                case 'A': return InputAction::ROTATE_CW;     // Up arrow
-                case 'B': return InputAction::MOVE_DOWN;     // Down arrow
-                case 'C': return InputAction::MOVE_RIGHT;    // Right arrow
-                case 'D': return InputAction::MOVE_LEFT;     // Left arrow
-            }
+
+void InputHandler::readerLoop() {
+    KeyDecoder decoder;
+    unsigned char bytes[64];
+
+    struct pollfd fds[2];
+    fds[0] = {STDIN_FILENO, POLLIN, 0};
+    fds[1] = {wakePipe[0], POLLIN, 0};
+    const nfds_t fdCount = wakePipe[0] >= 0 ? 2 : 1;
+
+    while (!stopping.load()) {
+        // An unfinished escape sequence gets a short grace period for its
+        // remaining bytes; otherwise block until input or shutdown
+        int timeout = decoder.hasPartial() ? ESCAPE_TIMEOUT_MS : -1;
+        int ready = poll(fds, fdCount, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fdCount > 1 && fds[1].revents != 0) {
+            break;
         }
-        return InputAction::NONE;
+        if (ready == 0) {
+            // A lone ESC or a truncated sequence: nothing we can map
+            decoder.reset();
+            continue;
+        }
+        if ((fds[0].revents & POLLIN) == 0) {
+            if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL)) break;
+            continue;
+        }
+
+        ssize_t count = read(STDIN_FILENO, bytes, sizeof(bytes));
+        if (count <= 0) {
+            if (count < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            break; // stdin closed
+        }
+        auto now = std::chrono::steady_clock::now();
+        decoder.feed(bytes, static_cast<size_t>(count), [&](InputAction action) {
+            pushAction(action, now);
+        });
+        ringDoorbell();
     }
 
-    switch (ch) {
-        case ' ':  return InputAction::HARD_DROP;
-        case '\n': return InputAction::START;
-        case 'z':
-        case 'Z':  return InputAction::ROTATE_CW;
-        case 'x':
-        case 'X':  return InputAction::ROTATE_CCW;
-        case 'p':
-        case 'P':  return InputAction::PAUSE;
-        case 'q':
-        case 'Q':  return InputAction::QUIT;
-        case 'r':
-        case 'R':  return InputAction::RESTART;
-        case 'w':
-        case 'W':  return InputAction::ROTATE_CW;
-        case 's':
-        case 'S':  return InputAction::MOVE_DOWN;
-        case 'a':
-        case 'A':  return InputAction::MOVE_LEFT;
-        case 'd':
-        case 'D':  return InputAction::MOVE_RIGHT;
-        default:   return InputAction::NONE;
+    if (!stopping.load()) {
+        closed.store(true);
+        ringDoorbell();
     }
-#endif
 }
+
+#endif
@@ -0,0 +1,30 @@
+#include "../../include/Controller/KeyDecoder.h"
+
+InputAction KeyDecoder::mapKey(int ch) {
+    switch (ch) {
+        case ' ':  return InputAction::HARD_DROP;
+        case '\n':
+        case '\r': return InputAction::START;
+        case 'z':
+        case 'Z':  return InputAction::ROTATE_CW;
+        case 'x':
+        case 'X':  return InputAction::ROTATE_CCW;
+        case 'p':
+        case 'P':  return InputAction::PAUSE;
+        case 'q':
+        case 'Q':  return InputAction::QUIT;
+        case 'r':
+        case 'R':  return InputAction::RESTART;
+        case 'w':
+        case 'W':  return InputAction::ROTATE_CW;
+        case 's':
+        case 'S':  return InputAction::MOVE_DOWN;
+        case 'a':
+        case 'A':  return InputAction::MOVE_LEFT;
+        case 'd':
+        case 'D':  return InputAction::MOVE_RIGHT;
+        case 'f':
+        case 'F':  return InputAction::TOGGLE_STATS;
+        default:   return InputAction::NONE;
+    }
+}
@@ -1,126 +1,387 @@
 #include "../../include/Model/Board.h"
+#include "../../include/Model/Random.h"
 
-Board::Board() {
-    clear();
-}
+namespace {
+template <int W, int H>
+using CellKeys = std::array<std::array<uint64_t, W>, H>;
 
-void Board::clear() {
-    grid.clear();
-    grid.resize(HEIGHT, std::vector<int>(WIDTH, 0));
+// One random key per cell, fixed at compile time so hashes are stable
+// across runs and threads
+template <int W, int H>
+constexpr CellKeys<W, H> makeCellKeys() {
+    CellKeys<W, H> keys{};
+    uint64_t state = 0x5A0B81C73D2EF496ULL;
+    for (auto& row : keys) {
+        for (auto& key : row) {
+            key = Random::splitMix64(state);
+        }
+    }
+    return keys;
 }
 
-bool Board::canPlace(const Tetromino& tetromino, int x, int y) const {
-    const auto& shape = tetromino.getShape();
+template <int W, int H>
+constexpr CellKeys<W, H> CELL_KEYS = makeCellKeys<W, H>();
+}
 
-    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
-        for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
-            if (shape[row][col] != 0) {
-                int boardX = x + col;
-                int boardY = y + row;
-
-                // Check bounds
-                if (boardX < 0 || boardX >= WIDTH || boardY >= HEIGHT) {
-                    return false;
-                }
+template <int W, int H>
+BasicBoard<W, H>::BasicBoard() {
+    clear();
+}
 
-                // Allow placement above the board (for spawning)
-                if (boardY < 0) {
-                    continue;
-                }
+template <int W, int H>
+void BasicBoard<W, H>::clear() {
+    rows.fill(0);
+    for (int pad = 0; pad < PAD_ROWS; ++pad) {
+        rowAt(HEIGHT + pad) = FULL_ROW;
+    }
+    columnTops.fill(static_cast<int8_t>(HEIGHT));
+    hash = 0;
+    for (int row = 0; row < HEIGHT; ++row) {
+        colorSlots[row].fill(0);
+        colorIndex[row] = static_cast<uint8_t>(row);
+    }
+}
 
-                // Check collision with existing blocks
-                if (grid[boardY][boardX] != 0) {
-                    return false;
-                }
+template <int W, int H>
+void BasicBoard<W, H>::setCells(const std::array<ColorRow, HEIGHT>& colors) {
+    clear();
+    for (int row = 0; row < HEIGHT; ++row) {
+        Row bits = 0;
+        for (int col = 0; col < WIDTH; ++col) {
+            if (colors[row][col] != 0) {
+                bits |= static_cast<Row>(static_cast<Row>(1) << col);
             }
         }
+        rowAt(row) = bits;
+        colorSlots[row] = colors[row];
+        hash ^= rowHash(row);
+    }
+    rebuildColumnTops();
+}
+
+template <int W, int H>
+bool BasicBoard<W, H>::canPlace(const Tetromino& tetromino, int x, int y) const {
+    // Every piece has at least one cell, so it cannot fit once the whole
+    // matrix is past a wall or the floor
+    if (x <= -Tetromino::MATRIX_SIZE || x >= WIDTH || y >= HEIGHT) {
+        return false;
+    }
+
+    // Allow placement above the board (for spawning): a matrix wholly above
+    // it only meets the walls, which the empty pad rows give as well
+    const Row* covered = &rows[PAD_ROWS + (y < -PAD_ROWS ? -PAD_ROWS : y)];
+    const uint64_t lanes = tetromino.getRowMaskLanes();
+    const int shift = x + GUARD_BITS;
+
+    // Piece rows and board rows line up lane for lane, and shifting a whole
+    // word never carries a bit into the next lane thanks to the guard bits
+    if constexpr (ROW_BITS == 16) {
+        uint64_t board = static_cast<uint64_t>(covered[0])
+                       | static_cast<uint64_t>(covered[1]) << 16
+                       | static_cast<uint64_t>(covered[2]) << 32
+                       | static_cast<uint64_t>(covered[3]) << 48;
+        return ((lanes << shift) & ((board << GUARD_BITS) | WALL_LANES)) == 0;
+    } else if constexpr (ROW_BITS == 32) {
+        uint64_t pieceLow = (lanes & 0xFFFF) | (lanes & 0xFFFF0000) << 16;
+        uint64_t pieceHigh = (lanes >> 32 & 0xFFFF) | (lanes >> 48) << 32;
+        uint64_t boardLow = static_cast<uint64_t>(covered[0]) | static_cast<uint64_t>(covered[1]) << 32;
+        uint64_t boardHigh = static_cast<uint64_t>(covered[2]) | static_cast<uint64_t>(covered[3]) << 32;
+        uint64_t hit = (pieceLow << shift) & ((boardLow << GUARD_BITS) | WALL_LANES);
+        hit |= (pieceHigh << shift) & ((boardHigh << GUARD_BITS) | WALL_LANES);
+        return hit == 0;
+    } else {
+        uint64_t hit = ((lanes & 0xFFFF) << shift) & ((covered[0] << GUARD_BITS) | WALL_LANES);
+        hit |= ((lanes >> 16 & 0xFFFF) << shift) & ((covered[1] << GUARD_BITS) | WALL_LANES);
+        hit |= ((lanes >> 32 & 0xFFFF) << shift) & ((covered[2] << GUARD_BITS) | WALL_LANES);
+        hit |= ((lanes >> 48) << shift) & ((covered[3] << GUARD_BITS) | WALL_LANES);
+        return hit == 0;
     }
-    return true;
 }
 
-void Board::place(const Tetromino& tetromino, int x, int y) {
-    const auto& shape = tetromino.getShape();
-    int typeValue = static_cast<int>(tetromino.getType()) + 1; // +1 so 0 remains empty
+template <int W, int H>
+typename BasicBoard<W, H>::Row BasicBoard<W, H>::pieceRowBits(uint8_t mask, int x) {
+    return static_cast<Row>(((static_cast<uint64_t>(mask) << (x + GUARD_BITS)) >> GUARD_BITS) & FULL_ROW);
+}
+
+template <int W, int H>
+void BasicBoard<W, H>::place(const Tetromino& tetromino, int x, int y) {
+    const auto& masks = tetromino.getRowMasks();
+    uint8_t typeValue = static_cast<uint8_t>(static_cast<int>(tetromino.getType()) + 1); // +1 so 0 remains empty
 
     for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
-        for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
-            if (shape[row][col] != 0) {
-                int boardX = x + col;
-                int boardY = y + row;
+        int boardY = y + row;
+        if (masks[row] == 0 || boardY < 0 || boardY >= HEIGHT) {
+            continue;
+        }
+
+        Row placed = pieceRowBits(masks[row], x);
+        rowAt(boardY) |= placed;
 
-                if (boardY >= 0 && boardY < HEIGHT && boardX >= 0 && boardX < WIDTH) {
-                    grid[boardY][boardX] = typeValue;
+        ColorRow& colorRow = colorSlots[colorIndex[boardY]];
+        for (int col = 0; col < WIDTH; ++col) {
+            if (placed & (static_cast<Row>(1) << col)) {
+                colorRow[col] = typeValue;
+                hash ^= CELL_KEYS<W, H>[boardY][col];
+                if (boardY < columnTops[col]) {
+                    columnTops[col] = static_cast<int8_t>(boardY);
                 }
             }
         }
     }
 }
 
-int Board::clearLines() {
+template <int W, int H>
+int BasicBoard<W, H>::clearLines() {
+    // Rows above the highest column top are empty and stay put, so the
+    // pass only covers the stack
+    int stackTop = HEIGHT;
+    for (int col = 0; col < WIDTH; ++col) {
+        if (columnTops[col] < stackTop) {
+            stackTop = columnTops[col];
+        }
+    }
+
+    // Single compaction pass from the bottom: surviving rows slide down over
+    // the full ones, taking their colour slots with them; the full rows'
+    // slots are wiped and reused for the rows vacated at the top. Rows below
+    // the lowest full one stay where they are, so only those from it up have
+    // their keys taken out of the hash here and the moved ones put back after.
+    std::array<uint8_t, HEIGHT> freedSlots;
     int linesCleared = 0;
+    int writeRow = HEIGHT - 1;
+    int lowestCleared = -1;
 
-    for (int row = HEIGHT - 1; row >= 0; --row) {
-        if (isRowFull(row)) {
-            clearRow(row);
-            shiftRowsDown(row);
-            ++linesCleared;
-            ++row; // Check this row again since rows shifted down
+    for (int row = HEIGHT - 1; row >= stackTop; --row) {
+        if (lowestCleared < 0 && rowAt(row) == FULL_ROW) {
+            lowestCleared = row;
+        }
+        if (lowestCleared >= 0) {
+            hash ^= rowHash(row);
+        }
+        if (rowAt(row) == FULL_ROW) {
+            freedSlots[linesCleared++] = colorIndex[row];
+            continue;
         }
+        if (writeRow != row) {
+            rowAt(writeRow) = rowAt(row);
+            colorIndex[writeRow] = colorIndex[row];
+        }
+        --writeRow;
     }
 
-    return linesCleared;
-}
+    if (linesCleared == 0) {
+        return 0;
+    }
 
-int Board::getCell(int x, int y) const {
-    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
-        return -1;
+    for (int freed = 0; writeRow >= stackTop; --writeRow) {
+        rowAt(writeRow) = 0;
+        colorIndex[writeRow] = freedSlots[freed];
+        colorSlots[freedSlots[freed++]].fill(0);
     }
-    return grid[y][x];
+
+    rebuildColumnTops();
+    for (int row = stackTop + linesCleared; row <= lowestCleared; ++row) {
+        hash ^= rowHash(row);
+    }
+    return linesCleared;
 }
 
-bool Board::isRowFull(int row) const {
-    if (row < 0 || row >= HEIGHT) {
-        return false;
+template <int W, int H>
+int BasicBoard<W, H>::placeAndClear(const Tetromino& tetromino, int x, int y, Undo& undo) {
+    undo.columnTops = columnTops;
+    undo.hash = hash;
+    undo.placedY = static_cast<int8_t>(y);
+
+    const auto& masks = tetromino.getRowMasks();
+    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+        int boardY = y + row;
+        Row bits = 0;
+        if (masks[row] != 0 && boardY >= 0 && boardY < HEIGHT) {
+            bits = pieceRowBits(masks[row], x);
+        }
+        undo.placedBits[row] = bits;
     }
 
+    place(tetromino, x, y);
+
+    int8_t stackTop = static_cast<int8_t>(HEIGHT);
     for (int col = 0; col < WIDTH; ++col) {
-        if (grid[row][col] == 0) {
-            return false;
+        if (columnTops[col] < stackTop) {
+            stackTop = columnTops[col];
         }
     }
-    return true;
+    undo.stackTop = stackTop;
+
+    int cleared = 0;
+    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+        int boardY = y + row;
+        if (undo.placedBits[row] != 0 && rowAt(boardY) == FULL_ROW) {
+            undo.clearedRows[cleared] = static_cast<int8_t>(boardY);
+            undo.clearedColors[cleared] = colorSlots[colorIndex[boardY]];
+            ++cleared;
+        }
+    }
+    undo.clearedCount = static_cast<uint8_t>(cleared);
+
+    return cleared > 0 ? clearLines() : 0;
 }
 
-bool Board::isGameOver() const {
-    // Check if any blocks are in the top two rows (spawn area)
-    for (int row = 0; row < 2; ++row) {
+template <int W, int H>
+void BasicBoard<W, H>::undo(const Undo& undo) {
+    const int cleared = undo.clearedCount;
+    if (cleared > 0) {
+        // clearLines() handed the k-th cleared row from the bottom's slot to
+        // the k-th vacated row from the bottom, so vacated row i goes back
+        // to cleared row i, both counted from the top
+        std::array<uint8_t, Tetromino::MATRIX_SIZE> slots;
+        for (int i = 0; i < cleared; ++i) {
+            slots[i] = colorIndex[undo.stackTop + i];
+        }
+
+        // Walk down from the old stack top: cleared rows are reinstated and
+        // survivors move back up past the cleared rows still below them.
+        // Every read is at or below the row being written, so nothing is
+        // overwritten before it is read.
+        int next = 0;
+        for (int row = undo.stackTop; next < cleared; ++row) {
+            if (undo.clearedRows[next] == row) {
+                rowAt(row) = FULL_ROW;
+                colorIndex[row] = slots[next];
+                colorSlots[slots[next]] = undo.clearedColors[next];
+                ++next;
+            } else {
+                int from = row + cleared - next;
+                rowAt(row) = rowAt(from);
+                colorIndex[row] = colorIndex[from];
+            }
+        }
+    }
+
+    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+        Row bits = undo.placedBits[row];
+        if (bits == 0) {
+            continue;
+        }
+        int boardY = undo.placedY + row;
+        rowAt(boardY) = static_cast<Row>(rowAt(boardY) & ~bits);
+        ColorRow& colorRow = colorSlots[colorIndex[boardY]];
         for (int col = 0; col < WIDTH; ++col) {
-            if (grid[row][col] != 0) {
-                return true;
+            if (bits & (static_cast<Row>(1) << col)) {
+                colorRow[col] = 0;
             }
         }
     }
-    return false;
+
+    columnTops = undo.columnTops;
+    hash = undo.hash;
 }
 
-const std::vector<std::vector<int>>& Board::getGrid() const {
-    return grid;
+template <int W, int H>
+uint64_t BasicBoard<W, H>::rowHash(int row) const {
+    uint64_t keys = 0;
+    Row bits = rowAt(row);
+    for (int col = 0; bits != 0; ++col, bits >>= 1) {
+        if (bits & 1u) {
+            keys ^= CELL_KEYS<W, H>[row][col];
+        }
+    }
+    return keys;
 }
 
-void Board::clearRow(int row) {
-    for (int col = 0; col < WIDTH; ++col) {
-        grid[row][col] = 0;
+template <int W, int H>
+void BasicBoard<W, H>::rebuildColumnTops() {
+    // A clear can expose a hole as a column's new top, so rescan from the
+    // top; each column is settled by the first row that covers it
+    columnTops.fill(static_cast<int8_t>(HEIGHT));
+    Row covered = 0;
+    for (int row = 0; row < HEIGHT && covered != FULL_ROW; ++row) {
+        Row fresh = static_cast<Row>(rowAt(row) & ~covered);
+        for (int col = 0; fresh != 0; ++col, fresh >>= 1) {
+            if (fresh & 1u) {
+                columnTops[col] = static_cast<int8_t>(row);
+            }
+        }
+        covered |= rowAt(row);
     }
 }
 
-void Board::shiftRowsDown(int fromRow) {
-    for (int row = fromRow; row > 0; --row) {
-        for (int col = 0; col < WIDTH; ++col) {
-            grid[row][col] = grid[row - 1][col];
+template <int W, int H>
+int BasicBoard<W, H>::getLandingY(const Tetromino& tetromino, int x, int y) const {
+    // Each column stops the piece where its lowest cell meets the column
+    // top. That holds only while the piece is above the surface; tucked
+    // under an overhang, fall back to probing row by row.
+    const auto& bottoms = tetromino.getColumnBottoms();
+    int landing = HEIGHT;
+    bool hasCells = false;
+    for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+        if (bottoms[col] < 0) {
+            continue;
+        }
+        hasCells = true;
+        int top = columnTops[x + col];
+        if (y + bottoms[col] >= top) {
+            landing = y;
+            while (canPlace(tetromino, x, landing + 1)) {
+                ++landing;
+            }
+            return landing;
+        }
+        if (top - 1 - bottoms[col] < landing) {
+            landing = top - 1 - bottoms[col];
         }
     }
-    // Clear top row
-    for (int col = 0; col < WIDTH; ++col) {
-        grid[0][col] = 0;
+    return hasCells ? landing : y;
+}
+
+template <int W, int H>
+uint64_t BasicBoard<W, H>::getHash() const {
+    return hash;
+}
+
+template <int W, int H>
+int BasicBoard<W, H>::getColumnTop(int x) const {
+    if (x < 0 || x >= WIDTH) {
+        return 0;
+    }
+    return columnTops[x];
+}
+
+template <int W, int H>
+int BasicBoard<W, H>::getCell(int x, int y) const {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
+        return -1;
+    }
+    return colorSlots[colorIndex[y]][x];
+}
+
+template <int W, int H>
+typename BasicBoard<W, H>::Row BasicBoard<W, H>::getRow(int y) const {
+    if (y < 0 || y >= HEIGHT) {
+        return FULL_ROW;
+    }
+    return rowAt(y);
+}
+
+template <int W, int H>
+bool BasicBoard<W, H>::isRowFull(int row) const {
+    if (row < 0 || row >= HEIGHT) {
+        return false;
     }
+    return rowAt(row) == FULL_ROW;
 }
+
+template <int W, int H>
+bool BasicBoard<W, H>::isGameOver() const {
+    // Check if any blocks are in the top two rows (spawn area)
+    return (rowAt(0) | rowAt(1)) != 0;
+}
+
+template <int W, int H>
+const typename BasicBoard<W, H>::ColorRow& BasicBoard<W, H>::getColorRow(int y) const {
+    return colorSlots[colorIndex[y]];
+}
+
+template class BasicBoard<10, 20>;
+template class BasicBoard<10, 40>;
+template class BasicBoard<16, 20>;
+template class BasicBoard<32, 20>;
@@ -0,0 +1,427 @@
+#include "../../include/Model/BoardKernels.h"
+#include <cstring>
+
+// The vector paths are compiled per function with target attributes, so
+// the rest of the build keeps its baseline instruction set
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BOARD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(Board::Row) == 2, "the kernels pack four 16-bit rows into a word");
+
+namespace {
+
+#ifdef BOARD_KERNELS_X86
+
+constexpr int WIDTH = Board::WIDTH;
+constexpr int HEIGHT = Board::HEIGHT;
+constexpr int GUARD_BITS = Tetromino::MATRIX_SIZE - 1;
+constexpr int PAD_ROWS = Tetromino::MATRIX_SIZE;
+constexpr uint64_t WALL_LANES =
+    static_cast<uint16_t>(~(Board::FULL_ROW << GUARD_BITS)) * 0x0001000100010001ULL;
+
+// Piece masks by type * PIECE_ROTATIONS + rotation, NONE included, so a
+// probe's first two bytes index them directly
+struct PieceLanes {
+    alignas(64) uint64_t lanes[(PIECE_TYPES + 1) * PIECE_ROTATIONS];
+
+    PieceLanes() {
+        for (int type = 0; type <= PIECE_TYPES; ++type) {
+            for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+                lanes[type * PIECE_ROTATIONS + rotation] = PIECE_TABLE[type][rotation].rowMaskLanes;
+            }
+        }
+    }
+};
+
+const PieceLanes PIECE_LANES;
+
+// Lowest filled row of each matrix column by piece, indexed like
+// PieceLanes, one 32-byte table per column so byte shuffles look them up;
+// EMPTY_COLUMN marks a column without cells
+const uint8_t EMPTY_COLUMN = 0xFF;
+
+struct PieceBottoms {
+    alignas(32) uint8_t columns[Tetromino::MATRIX_SIZE][(PIECE_TYPES + 1) * PIECE_ROTATIONS];
+
+    PieceBottoms() {
+        for (int type = 0; type <= PIECE_TYPES; ++type) {
+            for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+                for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+                    int8_t bottom = PIECE_TABLE[type][rotation].columnBottoms[col];
+                    columns[col][type * PIECE_ROTATIONS + rotation] =
+                        bottom < 0 ? EMPTY_COLUMN : static_cast<uint8_t>(bottom);
+                }
+            }
+        }
+    }
+};
+
+static_assert((PIECE_TYPES + 1) * PIECE_ROTATIONS == 32, "each bottoms table is two 16-byte shuffles");
+
+const PieceBottoms PIECE_BOTTOMS;
+
+// The board's column tops, which Board::getLandingY starts from, one byte
+// each at column + GUARD_BITS so a byte shuffle looks up sixteen at once.
+// The columns past the walls read as empty and are never under a cell.
+struct Skyline {
+    alignas(16) uint8_t tops[GUARD_BITS + WIDTH + GUARD_BITS];
+
+    explicit Skyline(const Board& board) {
+        for (int col = -GUARD_BITS; col < WIDTH + GUARD_BITS; ++col) {
+            tops[GUARD_BITS + col] = static_cast<uint8_t>(col >= 0 && col < WIDTH ? board.getColumnTop(col) : HEIGHT);
+        }
+    }
+};
+
+static_assert(GUARD_BITS + WIDTH + GUARD_BITS == 16, "the skyline fills one 16-byte shuffle table");
+
+// The word Board::canPlace tests a piece against at row y: rows y to y + 3
+// shifted past the guard bits with the walls set, for y from -PAD_ROWS to
+// HEIGHT - 1
+struct Windows {
+    alignas(64) uint64_t words[PAD_ROWS + HEIGHT];
+
+    explicit Windows(const Board& board) {
+        const Board::Row* rows = board.getRowWords();
+        for (int y = -PAD_ROWS; y < HEIGHT; ++y) {
+            uint64_t covered;
+            std::memcpy(&covered, rows + y, sizeof(covered));
+            words[PAD_ROWS + y] = (covered << GUARD_BITS) | WALL_LANES;
+        }
+    }
+
+    uint64_t at(int y) const {
+        return words[PAD_ROWS + (y < -PAD_ROWS ? -PAD_ROWS : y)];
+    }
+};
+
+// One result byte per bit of a four-bit mask
+inline void storeMask4(uint8_t* results, int mask) {
+    uint32_t bytes = static_cast<uint32_t>((mask & 1) | (mask & 2) << 7 | (mask & 4) << 14 | (mask & 8) << 21);
+    std::memcpy(results, &bytes, sizeof(bytes));
+}
+
+// ---- AVX2: collisions four probes per pass, landings eight -------------
+
+__attribute__((target("avx2")))
+void canPlaceAvx2(const Board& board, const PlacementProbe* probes, size_t count, uint8_t* results) {
+    const Windows windows(board);
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Each probe is one 32-bit lane: type, rotation, x, y from the bottom
+        __m128i probe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(probes + i));
+        __m128i type = _mm_and_si128(probe, byteMask);
+        __m128i rotation = _mm_and_si128(_mm_srli_epi32(probe, 8), byteMask);
+        __m128i x = _mm_srai_epi32(_mm_slli_epi32(probe, 8), 24);
+        __m128i y = _mm_srai_epi32(probe, 24);
+
+        __m128i inBounds = _mm_and_si128(
+            _mm_and_si128(_mm_cmpgt_epi32(x, _mm_set1_epi32(-Tetromino::MATRIX_SIZE)),
+                          _mm_cmplt_epi32(x, _mm_set1_epi32(WIDTH))),
+            _mm_cmplt_epi32(y, _mm_set1_epi32(HEIGHT)));
+        // Out-of-bounds rows are clamped only to keep the gather in range
+        __m128i row = _mm_min_epi32(_mm_max_epi32(y, _mm_set1_epi32(-PAD_ROWS)), _mm_set1_epi32(HEIGHT - 1));
+        row = _mm_add_epi32(row, _mm_set1_epi32(PAD_ROWS));
+        __m128i piece = _mm_add_epi32(_mm_slli_epi32(type, 2), rotation);
+        __m128i shift = _mm_add_epi32(x, _mm_set1_epi32(GUARD_BITS));
+
+        __m256i lanes = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(PIECE_LANES.lanes), piece, 8);
+        __m256i covered = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(windows.words), row, 8);
+        lanes = _mm256_sllv_epi64(lanes, _mm256_cvtepi32_epi64(shift));
+        __m256i fits = _mm256_cmpeq_epi64(_mm256_and_si256(lanes, covered), _mm256_setzero_si256());
+
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(fits)) & _mm_movemask_ps(_mm_castsi128_ps(inBounds));
+        storeMask4(results + i, mask);
+    }
+    for (; i < count; ++i) {
+        results[i] = board.canPlace(probes[i].piece, probes[i].x, probes[i].y);
+    }
+}
+
+__attribute__((target("avx2")))
+void getLandingYAvx2(const Board& board, const PlacementProbe* probes, size_t count, int8_t* results) {
+    // Shuffle indices with the high bit set read as zero, so only the low
+    // byte of each 32-bit lane picks a table entry
+    const __m256i lowByteOnly = _mm256_set1_epi32(static_cast<int>(0x80808000u));
+    const Skyline skyline(board);
+    const __m256i tops = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(skyline.tops)));
+    __m256i bottomTables[Tetromino::MATRIX_SIZE][2];
+    for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+        for (int half = 0; half < 2; ++half) {
+            bottomTables[col][half] = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(PIECE_BOTTOMS.columns[col] + 16 * half)));
+        }
+    }
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i emptyColumn = _mm256_set1_epi32(EMPTY_COLUMN);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i probe = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(probes + i));
+        __m256i type = _mm256_and_si256(probe, byteMask);
+        __m256i rotation = _mm256_and_si256(_mm256_srli_epi32(probe, 8), byteMask);
+        __m256i x = _mm256_srai_epi32(_mm256_slli_epi32(probe, 8), 24);
+        __m256i y = _mm256_srai_epi32(probe, 24);
+        __m256i piece = _mm256_add_epi32(_mm256_slli_epi32(type, 2), rotation);
+        __m256i pieceIndex = _mm256_or_si256(piece, lowByteOnly);
+        // Bit 4 of the index picks the table half, moved up to the sign bit
+        __m256 secondHalf = _mm256_castsi256_ps(_mm256_slli_epi32(piece, 27));
+
+        // The highest row any column lets the piece reach, and whether a
+        // column starts below its top (an overhang)
+        __m256i landing = _mm256_set1_epi32(HEIGHT);
+        __m256i hasCells = _mm256_setzero_si256();
+        __m256i overhang = _mm256_setzero_si256();
+        for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+            __m256i bottom = _mm256_castps_si256(_mm256_blendv_ps(
+                _mm256_castsi256_ps(_mm256_shuffle_epi8(bottomTables[col][0], pieceIndex)),
+                _mm256_castsi256_ps(_mm256_shuffle_epi8(bottomTables[col][1], pieceIndex)),
+                secondHalf));
+            __m256i column = _mm256_add_epi32(x, _mm256_set1_epi32(col + GUARD_BITS));
+            __m256i top = _mm256_shuffle_epi8(tops, _mm256_or_si256(column, lowByteOnly));
+            __m256i filled = _mm256_cmpgt_epi32(emptyColumn, bottom);
+            __m256i rest = _mm256_sub_epi32(_mm256_sub_epi32(top, one), bottom);
+            landing = _mm256_blendv_epi8(landing, _mm256_min_epi32(landing, rest), filled);
+            overhang = _mm256_or_si256(overhang, _mm256_and_si256(filled,
+                _mm256_cmpgt_epi32(_mm256_add_epi32(_mm256_add_epi32(y, bottom), one), top)));
+            hasCells = _mm256_or_si256(hasCells, filled);
+        }
+        landing = _mm256_blendv_epi8(y, landing, hasCells);
+
+        // The low byte of each lane, in order, to the results
+        __m256i packed = _mm256_shuffle_epi8(landing, _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+        uint64_t bytes = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(packed)));
+        std::memcpy(results + i, &bytes, sizeof(bytes));
+        // Tucked under an overhang: Board probes those row by row
+        for (int lanes = _mm256_movemask_ps(_mm256_castsi256_ps(overhang)); lanes != 0; lanes &= lanes - 1) {
+            const PlacementProbe& tucked = probes[i + __builtin_ctz(static_cast<unsigned>(lanes))];
+            results[i + __builtin_ctz(static_cast<unsigned>(lanes))] =
+                static_cast<int8_t>(board.getLandingY(tucked.piece, tucked.x, tucked.y));
+        }
+    }
+    for (; i < count; ++i) {
+        results[i] = static_cast<int8_t>(board.getLandingY(probes[i].piece, probes[i].x, probes[i].y));
+    }
+}
+
+__attribute__((target("avx2")))
+void getFullRowsAvx2(const Board* boards, size_t count, uint32_t* masks) {
+    static_assert(HEIGHT > 16 && HEIGHT <= 24, "rows 0-15 and 16-23 are two loads");
+    const __m256i full = _mm256_set1_epi16(static_cast<short>(Board::FULL_ROW));
+    for (size_t i = 0; i < count; ++i) {
+        const Board::Row* rows = boards[i].getRowWords();
+        __m256i top = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows)), full);
+        __m128i bottom = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 16)),
+                                         _mm256_castsi256_si128(full));
+        // Saturating packs keep the rows in order, one byte each
+        uint32_t upper = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_packs_epi16(_mm256_castsi256_si128(top), _mm256_extracti128_si256(top, 1))));
+        uint32_t lower = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(bottom, bottom)));
+        // The rows past the bottom are full padding
+        masks[i] = upper | (lower & ((1u << (HEIGHT - 16)) - 1)) << 16;
+    }
+}
+
+// ---- SSE4.1: landings four probes per pass -----------------------------
+
+// Without gathers or per-lane 64-bit shifts, packing probes into vectors
+// costs more than it saves, so this level tests one probe at a time against
+// the precomputed windows, which still spares Board::canPlace assembling
+// the word for every probe
+void canPlaceWindows(const Board& board, const PlacementProbe* probes, size_t count, uint8_t* results) {
+    const Windows windows(board);
+    for (size_t i = 0; i < count; ++i) {
+        const PlacementProbe& probe = probes[i];
+        bool inBounds = probe.x > -Tetromino::MATRIX_SIZE && probe.x < WIDTH && probe.y < HEIGHT;
+        results[i] = inBounds && ((probe.piece.getRowMaskLanes() << (probe.x + GUARD_BITS)) & windows.at(probe.y)) == 0;
+    }
+}
+
+__attribute__((target("sse4.1")))
+void getLandingYSse4(const Board& board, const PlacementProbe* probes, size_t count, int8_t* results) {
+    const __m128i lowByteOnly = _mm_set1_epi32(static_cast<int>(0x80808000u));
+    const Skyline skyline(board);
+    const __m128i tops = _mm_load_si128(reinterpret_cast<const __m128i*>(skyline.tops));
+    __m128i bottomTables[Tetromino::MATRIX_SIZE][2];
+    for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+        for (int half = 0; half < 2; ++half) {
+            bottomTables[col][half] = _mm_load_si128(reinterpret_cast<const __m128i*>(PIECE_BOTTOMS.columns[col] + 16 * half));
+        }
+    }
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i emptyColumn = _mm_set1_epi32(EMPTY_COLUMN);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i probe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(probes + i));
+        __m128i type = _mm_and_si128(probe, byteMask);
+        __m128i rotation = _mm_and_si128(_mm_srli_epi32(probe, 8), byteMask);
+        __m128i x = _mm_srai_epi32(_mm_slli_epi32(probe, 8), 24);
+        __m128i y = _mm_srai_epi32(probe, 24);
+        __m128i piece = _mm_add_epi32(_mm_slli_epi32(type, 2), rotation);
+        __m128i pieceIndex = _mm_or_si128(piece, lowByteOnly);
+        __m128 secondHalf = _mm_castsi128_ps(_mm_slli_epi32(piece, 27));
+
+        __m128i landing = _mm_set1_epi32(HEIGHT);
+        __m128i hasCells = _mm_setzero_si128();
+        __m128i overhang = _mm_setzero_si128();
+        for (int col = 0; col < Tetromino::MATRIX_SIZE; ++col) {
+            __m128i bottom = _mm_castps_si128(_mm_blendv_ps(
+                _mm_castsi128_ps(_mm_shuffle_epi8(bottomTables[col][0], pieceIndex)),
+                _mm_castsi128_ps(_mm_shuffle_epi8(bottomTables[col][1], pieceIndex)),
+                secondHalf));
+            __m128i column = _mm_add_epi32(x, _mm_set1_epi32(col + GUARD_BITS));
+            __m128i top = _mm_shuffle_epi8(tops, _mm_or_si128(column, lowByteOnly));
+            __m128i filled = _mm_cmpgt_epi32(emptyColumn, bottom);
+            __m128i rest = _mm_sub_epi32(_mm_sub_epi32(top, one), bottom);
+            landing = _mm_blendv_epi8(landing, _mm_min_epi32(landing, rest), filled);
+            overhang = _mm_or_si128(overhang, _mm_and_si128(filled,
+                _mm_cmpgt_epi32(_mm_add_epi32(_mm_add_epi32(y, bottom), one), top)));
+            hasCells = _mm_or_si128(hasCells, filled);
+        }
+        landing = _mm_blendv_epi8(y, landing, hasCells);
+
+        // One byte per lane, in order
+        uint32_t bytes = static_cast<uint32_t>(_mm_cvtsi128_si32(
+            _mm_shuffle_epi8(landing, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1))));
+        std::memcpy(results + i, &bytes, sizeof(bytes));
+        for (int lanes = _mm_movemask_ps(_mm_castsi128_ps(overhang)); lanes != 0; lanes &= lanes - 1) {
+            const PlacementProbe& tucked = probes[i + __builtin_ctz(static_cast<unsigned>(lanes))];
+            results[i + __builtin_ctz(static_cast<unsigned>(lanes))] =
+                static_cast<int8_t>(board.getLandingY(tucked.piece, tucked.x, tucked.y));
+        }
+    }
+    for (; i < count; ++i) {
+        results[i] = static_cast<int8_t>(board.getLandingY(probes[i].piece, probes[i].x, probes[i].y));
+    }
+}
+
+__attribute__((target("sse4.1")))
+void getFullRowsSse4(const Board* boards, size_t count, uint32_t* masks) {
+    const __m128i full = _mm_set1_epi16(static_cast<short>(Board::FULL_ROW));
+    for (size_t i = 0; i < count; ++i) {
+        const Board::Row* rows = boards[i].getRowWords();
+        __m128i first = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows)), full);
+        __m128i second = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 8)), full);
+        __m128i third = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 16)), full);
+        uint32_t upper = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(first, second)));
+        uint32_t lower = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(third, third)));
+        masks[i] = upper | (lower & ((1u << (HEIGHT - 16)) - 1)) << 16;
+    }
+}
+
+#endif
+
+// ---- Scalar: the Board calls themselves --------------------------------
+
+void canPlaceScalar(const Board& board, const PlacementProbe* probes, size_t count, uint8_t* results) {
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = board.canPlace(probes[i].piece, probes[i].x, probes[i].y);
+    }
+}
+
+void getLandingYScalar(const Board& board, const PlacementProbe* probes, size_t count, int8_t* results) {
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = static_cast<int8_t>(board.getLandingY(probes[i].piece, probes[i].x, probes[i].y));
+    }
+}
+
+void getFullRowsScalar(const Board* boards, size_t count, uint32_t* masks) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t mask = 0;
+        for (int y = 0; y < Board::HEIGHT; ++y) {
+            mask |= static_cast<uint32_t>(boards[i].isRowFull(y)) << y;
+        }
+        masks[i] = mask;
+    }
+}
+
+}
+
+BoardKernels::Isa BoardKernels::getBestIsa() {
+#ifdef BOARD_KERNELS_X86
+    static const Isa best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return Isa::SSE4;
+        return Isa::SCALAR;
+    }();
+    return best;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+const char* BoardKernels::getIsaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::SSE4:
+            return "sse4";
+        case Isa::SCALAR:
+            break;
+    }
+    return "scalar";
+}
+
+BoardKernels::BoardKernels(Isa requested)
+    : isa(static_cast<int>(requested) > static_cast<int>(getBestIsa()) ? getBestIsa() : requested) {
+}
+
+BoardKernels::Isa BoardKernels::getIsa() const {
+    return isa;
+}
+
+void BoardKernels::canPlace(const Board& board, const PlacementProbe* probes, size_t count, uint8_t* results) const {
+    switch (isa) {
+#ifdef BOARD_KERNELS_X86
+        case Isa::AVX2:
+            canPlaceAvx2(board, probes, count, results);
+            return;
+        case Isa::SSE4:
+            canPlaceWindows(board, probes, count, results);
+            return;
+#endif
+        default:
+            canPlaceScalar(board, probes, count, results);
+            return;
+    }
+}
+
+void BoardKernels::getLandingY(const Board& board, const PlacementProbe* probes, size_t count, int8_t* results) const {
+    switch (isa) {
+#ifdef BOARD_KERNELS_X86
+        case Isa::AVX2:
+            getLandingYAvx2(board, probes, count, results);
+            return;
+        case Isa::SSE4:
+            getLandingYSse4(board, probes, count, results);
+            return;
+#endif
+        default:
+            getLandingYScalar(board, probes, count, results);
+            return;
+    }
+}
+
+void BoardKernels::getFullRows(const Board* boards, size_t count, uint32_t* masks) const {
+    switch (isa) {
+#ifdef BOARD_KERNELS_X86
+        case Isa::AVX2:
+            getFullRowsAvx2(boards, count, masks);
+            return;
+        case Isa::SSE4:
+            getFullRowsSse4(boards, count, masks);
+            return;
+#endif
+        default:
+            getFullRowsScalar(boards, count, masks);
+            return;
+    }
+}
@@ -1,51 +1,115 @@
 #include "../../include/Model/Game.h"
+#include <cmath>
+#include <random>
 
-// Scoring based on original Nintendo scoring system
-const int Game::BASE_SCORE_PER_LINE[] = {0, 40, 100, 300, 1200};
+static uint64_t makeEntropySeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+template <int W, int H>
+BasicGame<W, H>::BasicGame() : BasicGame(makeEntropySeed()) {
+}
 
-Game::Game()
+template <int W, int H>
+BasicGame<W, H>::BasicGame(uint64_t seed)
     : currentX(0)
     , currentY(0)
     , score(0)
     , level(1)
     , linesCleared(0)
     , totalLinesCleared(0)
-    , state(GameState::MENU) {
+    , piecesPlaced(0)
+    , tickCount(0)
+    , gravityTicks(0)
+    , state(GameState::MENU)
+    , seed(seed)
+    , piecePolicy(PiecePolicy::UNIFORM)
+    , reseedPending(false)
+    , pieces(seed, piecePolicy)
+    , undoDepth(0) {
+}
+
+template <int W, int H>
+void BasicGame<W, H>::setSeed(uint64_t newSeed) {
+    seed = newSeed;
+    reseedPending = true;
+}
+
+template <int W, int H>
+uint64_t BasicGame<W, H>::getSeed() const {
+    return seed;
+}
+
+template <int W, int H>
+void BasicGame<W, H>::setPiecePolicy(PiecePolicy policy) {
+    piecePolicy = policy;
+    reseedPending = true;
+}
+
+template <int W, int H>
+PiecePolicy BasicGame<W, H>::getPiecePolicy() const {
+    return piecePolicy;
 }
 
-void Game::start() {
+template <int W, int H>
+void BasicGame<W, H>::setPreviewDepth(int depth) {
+    pieces.setPreviewDepth(depth);
+}
+
+template <int W, int H>
+int BasicGame<W, H>::getPreviewDepth() const {
+    return pieces.getPreviewDepth();
+}
+
+template <int W, int H>
+void BasicGame<W, H>::start() {
     reset();
     state = GameState::PLAYING;
 }
 
-void Game::pause() {
+template <int W, int H>
+void BasicGame<W, H>::pause() {
     if (state == GameState::PLAYING) {
         state = GameState::PAUSED;
     }
 }
 
-void Game::resume() {
+template <int W, int H>
+void BasicGame<W, H>::resume() {
     if (state == GameState::PAUSED) {
         state = GameState::PLAYING;
     }
 }
 
-void Game::reset() {
+template <int W, int H>
+void BasicGame<W, H>::reset() {
     board.clear();
     score = 0;
     level = 1;
     linesCleared = 0;
     totalLinesCleared = 0;
+    piecesPlaced = 0;
+    tickCount = 0;
+    gravityTicks = 0;
+    undoDepth = 0;
+
+    // Restarting continues the same stream unless a new seed or policy
+    // was set
+    if (reseedPending) {
+        pieces.reseed(seed, piecePolicy);
+        reseedPending = false;
+    }
 
-    currentTetromino = Tetromino::createRandom();
-    nextTetromino = Tetromino::createRandom();
+    currentTetromino = pieces.next();
 
     // Spawn position: centered at top
-    currentX = (Board::WIDTH - Tetromino::MATRIX_SIZE) / 2;
+    currentX = (W - Tetromino::MATRIX_SIZE) / 2;
     currentY = 0;
 }
 
-bool Game::moveLeft() {
+template <int W, int H>
+bool BasicGame<W, H>::moveLeft() {
     if (state != GameState::PLAYING) return false;
 
     if (board.canPlace(currentTetromino, currentX - 1, currentY)) {
@@ -55,7 +119,8 @@ bool Game::moveLeft() {
     return false;
 }
 
-bool Game::moveRight() {
+template <int W, int H>
+bool BasicGame<W, H>::moveRight() {
     if (state != GameState::PLAYING) return false;
 
     if (board.canPlace(currentTetromino, currentX + 1, currentY)) {
@@ -65,7 +130,8 @@ bool Game::moveRight() {
     return false;
 }
 
-bool Game::moveDown() {
+template <int W, int H>
+bool BasicGame<W, H>::moveDown() {
     if (state != GameState::PLAYING) return false;
 
     if (board.canPlace(currentTetromino, currentX, currentY + 1)) {
@@ -75,142 +141,319 @@ bool Game::moveDown() {
     return false;
 }
 
-void Game::hardDrop() {
+template <int W, int H>
+void BasicGame<W, H>::hardDrop() {
     if (state != GameState::PLAYING) return;
 
-    while (board.canPlace(currentTetromino, currentX, currentY + 1)) {
-        ++currentY;
-        score += 2; // Bonus points for hard drop
-    }
+    int landingY = board.getLandingY(currentTetromino, currentX, currentY);
+    score += 2 * (landingY - currentY); // Bonus points for hard drop
+    currentY = landingY;
     lockTetromino();
 }
 
-void Game::rotate() {
+template <int W, int H>
+void BasicGame<W, H>::rotate() {
     if (state != GameState::PLAYING) return;
+    rotateWithKicks(board, currentTetromino, currentX, currentY, true);
+}
 
-    Tetromino rotated = currentTetromino;
-    rotated.rotate();
+template <int W, int H>
+void BasicGame<W, H>::rotateCounterClockwise() {
+    if (state != GameState::PLAYING) return;
+    rotateWithKicks(board, currentTetromino, currentX, currentY, false);
+}
 
-    // Try normal rotation
-    if (board.canPlace(rotated, currentX, currentY)) {
-        currentTetromino = rotated;
-        return;
-    }
+template <int W, int H>
+int BasicGame<W, H>::getKickCount(bool clockwise) {
+    return clockwise ? 5 : 3;
+}
 
-    // Wall kick: try moving left or right
-    if (board.canPlace(rotated, currentX - 1, currentY)) {
-        currentTetromino = rotated;
-        --currentX;
-        return;
+template <int W, int H>
+bool BasicGame<W, H>::rotateWithKicks(const BoardType& board, Tetromino& tetromino, int& x, int y, bool clockwise) {
+    Tetromino rotated = tetromino;
+    if (clockwise) {
+        rotated.rotate();
+    } else {
+        rotated.rotateCounterClockwise();
     }
 
-    if (board.canPlace(rotated, currentX + 1, currentY)) {
-        currentTetromino = rotated;
-        ++currentX;
-        return;
+    const int kickCount = getKickCount(clockwise);
+    for (int i = 0; i < kickCount; ++i) {
+        if (board.canPlace(rotated, x + KICK_OFFSETS[i], y)) {
+            tetromino = rotated;
+            x += KICK_OFFSETS[i];
+            return true;
+        }
     }
+    return false;
+}
 
-    // Try moving 2 spaces (for I-piece)
-    if (board.canPlace(rotated, currentX - 2, currentY)) {
-        currentTetromino = rotated;
-        currentX -= 2;
-        return;
-    }
+template <int W, int H>
+void BasicGame<W, H>::update() {
+    if (state != GameState::PLAYING) return;
 
-    if (board.canPlace(rotated, currentX + 2, currentY)) {
-        currentTetromino = rotated;
-        currentX += 2;
-        return;
+    if (!moveDown()) {
+        lockTetromino();
     }
 }
 
-void Game::rotateCounterClockwise() {
-    if (state != GameState::PLAYING) return;
+template <int W, int H>
+void BasicGame<W, H>::spawnNewTetromino() {
+    currentTetromino = pieces.next();
 
-    Tetromino rotated = currentTetromino;
-    rotated.rotateCounterClockwise();
+    currentX = (W - Tetromino::MATRIX_SIZE) / 2;
+    currentY = 0;
 
-    if (board.canPlace(rotated, currentX, currentY)) {
-        currentTetromino = rotated;
-        return;
+    // Check if new piece can be placed
+    if (!board.canPlace(currentTetromino, currentX, currentY)) {
+        state = GameState::GAME_OVER;
     }
+}
 
-    // Wall kicks
-    if (board.canPlace(rotated, currentX - 1, currentY)) {
-        currentTetromino = rotated;
-        --currentX;
-        return;
+template <int W, int H>
+bool BasicGame<W, H>::applyAction(InputAction action) {
+    switch (state) {
+        case GameState::MENU:
+        case GameState::GAME_OVER:
+            if (action == InputAction::START || action == InputAction::RESTART) {
+                start();
+                return true;
+            }
+            return false;
+        case GameState::PAUSED:
+            if (action == InputAction::PAUSE) {
+                resume();
+                return true;
+            }
+            return false;
+        case GameState::PLAYING:
+            break;
     }
 
-    if (board.canPlace(rotated, currentX + 1, currentY)) {
-        currentTetromino = rotated;
-        ++currentX;
-        return;
+    switch (action) {
+        case InputAction::MOVE_LEFT:
+            return moveLeft();
+        case InputAction::MOVE_RIGHT:
+            return moveRight();
+        case InputAction::MOVE_DOWN:
+            // A successful soft drop restarts the gravity interval
+            if (moveDown()) {
+                gravityTicks = 0;
+                return true;
+            }
+            return false;
+        case InputAction::HARD_DROP:
+            hardDrop();
+            gravityTicks = 0;
+            return true;
+        case InputAction::ROTATE_CW:
+            rotate();
+            return true;
+        case InputAction::ROTATE_CCW:
+            rotateCounterClockwise();
+            return true;
+        case InputAction::PAUSE:
+            pause();
+            return true;
+        default:
+            return false;
     }
 }
 
-void Game::update() {
-    if (state != GameState::PLAYING) return;
+template <int W, int H>
+void BasicGame<W, H>::advance(int ticks) {
+    if (state != GameState::PLAYING || ticks <= 0) return;
 
-    if (!moveDown()) {
-        lockTetromino();
+    tickCount += ticks;
+    gravityTicks += ticks;
+
+    // Splitting a span of ticks across several calls gives the same result
+    // as advancing it in one call
+    int interval = getDropIntervalTicks();
+    while (state == GameState::PLAYING && gravityTicks >= interval) {
+        gravityTicks -= interval;
+        update();
+        interval = getDropIntervalTicks();
     }
 }
 
-void Game::spawnNewTetromino() {
-    currentTetromino = nextTetromino;
-    nextTetromino = Tetromino::createRandom();
+template <int W, int H>
+void BasicGame<W, H>::step(InputAction action, int ticks) {
+    applyAction(action);
+    advance(ticks);
+}
 
-    currentX = (Board::WIDTH - Tetromino::MATRIX_SIZE) / 2;
-    currentY = 0;
+template <int W, int H>
+bool BasicGame<W, H>::makeMove(const Tetromino& piece, int x, int y) {
+    if (state != GameState::PLAYING || undoDepth == MAX_UNDO_DEPTH || !board.canPlace(piece, x, y)) {
+        return false;
+    }
 
-    // Check if new piece can be placed
-    if (!board.canPlace(currentTetromino, currentX, currentY)) {
+    MoveUndo& undo = undoStack[undoDepth++];
+    undo.queue = pieces.checkpoint();
+    undo.piece = currentTetromino;
+    undo.x = currentX;
+    undo.y = currentY;
+    undo.score = score;
+    undo.level = level;
+    undo.totalLinesCleared = totalLinesCleared;
+    undo.piecesPlaced = piecesPlaced;
+    undo.gravityTicks = gravityTicks;
+    undo.state = state;
+
+    // Same bookkeeping as lockTetromino()
+    int lines = board.placeAndClear(piece, x, y, undo.board);
+    ++piecesPlaced;
+    if (lines > 0) {
+        updateScore(lines);
+        totalLinesCleared += lines;
+        updateLevel();
+    }
+    gravityTicks = 0;
+
+    undo.drewPiece = !board.isGameOver();
+    if (undo.drewPiece) {
+        spawnNewTetromino();
+    } else {
         state = GameState::GAME_OVER;
     }
+    return true;
+}
+
+template <int W, int H>
+bool BasicGame<W, H>::unmakeMove() {
+    if (undoDepth == 0) {
+        return false;
+    }
+
+    const MoveUndo& undo = undoStack[--undoDepth];
+    board.undo(undo.board);
+    if (undo.drewPiece) {
+        // The piece as it was drawn, not as it has been turned since
+        pieces.unget(Tetromino(currentTetromino.getType()), undo.queue);
+    }
+    currentTetromino = undo.piece;
+    currentX = undo.x;
+    currentY = undo.y;
+    score = undo.score;
+    level = undo.level;
+    totalLinesCleared = undo.totalLinesCleared;
+    piecesPlaced = undo.piecesPlaced;
+    gravityTicks = undo.gravityTicks;
+    state = undo.state;
+    return true;
+}
+
+template <int W, int H>
+int BasicGame<W, H>::getUndoDepth() const {
+    return undoDepth;
+}
+
+template <int W, int H>
+typename BasicGame<W, H>::Snapshot BasicGame<W, H>::snapshot() const {
+    Snapshot snapshot;
+    for (int y = 0; y < H; ++y) {
+        snapshot.cells[y] = board.getColorRow(y);
+    }
+    snapshot.current = currentTetromino;
+    snapshot.x = currentX;
+    snapshot.y = currentY;
+    snapshot.score = score;
+    snapshot.level = level;
+    snapshot.linesCleared = totalLinesCleared;
+    snapshot.piecesPlaced = piecesPlaced;
+    snapshot.tickCount = tickCount;
+    snapshot.gravityTicks = gravityTicks;
+    snapshot.state = state;
+    snapshot.seed = seed;
+    snapshot.piecePolicy = piecePolicy;
+    snapshot.reseedPending = reseedPending;
+    snapshot.pieces = pieces.snapshot();
+    return snapshot;
+}
+
+template <int W, int H>
+void BasicGame<W, H>::restore(const Snapshot& snapshot) {
+    board.setCells(snapshot.cells);
+    currentTetromino = snapshot.current;
+    currentX = snapshot.x;
+    currentY = snapshot.y;
+    score = snapshot.score;
+    level = snapshot.level;
+    totalLinesCleared = snapshot.linesCleared;
+    piecesPlaced = snapshot.piecesPlaced;
+    tickCount = snapshot.tickCount;
+    gravityTicks = snapshot.gravityTicks;
+    state = snapshot.state;
+    seed = snapshot.seed;
+    piecePolicy = snapshot.piecePolicy;
+    reseedPending = snapshot.reseedPending;
+    pieces.restore(snapshot.pieces);
+    undoDepth = 0;
 }
 
-int Game::getScore() const {
+template <int W, int H>
+int BasicGame<W, H>::getScore() const {
     return score;
 }
 
-int Game::getLevel() const {
+template <int W, int H>
+int BasicGame<W, H>::getLevel() const {
     return level;
 }
 
-int Game::getLinesCleared() const {
+template <int W, int H>
+int BasicGame<W, H>::getLinesCleared() const {
     return totalLinesCleared;
 }
 
-GameState Game::getState() const {
+template <int W, int H>
+long long BasicGame<W, H>::getPiecesPlaced() const {
+    return piecesPlaced;
+}
+
+template <int W, int H>
+GameState BasicGame<W, H>::getState() const {
     return state;
 }
 
-const Board& Game::getBoard() const {
+template <int W, int H>
+const typename BasicGame<W, H>::BoardType& BasicGame<W, H>::getBoard() const {
     return board;
 }
 
-const Tetromino& Game::getCurrentTetromino() const {
+template <int W, int H>
+const Tetromino& BasicGame<W, H>::getCurrentTetromino() const {
     return currentTetromino;
 }
 
-const Tetromino& Game::getNextTetromino() const {
-    return nextTetromino;
+template <int W, int H>
+const Tetromino& BasicGame<W, H>::getNextTetromino() const {
+    return pieces.peek(0);
 }
 
-int Game::getCurrentX() const {
+template <int W, int H>
+const Tetromino& BasicGame<W, H>::getPreview(int i) const {
+    return pieces.peek(i);
+}
+
+template <int W, int H>
+int BasicGame<W, H>::getCurrentX() const {
     return currentX;
 }
 
-int Game::getCurrentY() const {
+template <int W, int H>
+int BasicGame<W, H>::getCurrentY() const {
     return currentY;
 }
 
-int Game::getGhostY() const {
+template <int W, int H>
+int BasicGame<W, H>::getGhostY() const {
     return calculateGhostY();
 }
 
-double Game::getDropInterval() const {
+template <int W, int H>
+double BasicGame<W, H>::getDropInterval() const {
     // Speed increases with level (milliseconds between drops)
     // Level 1: 1000ms, Level 10: ~100ms, Level 20: ~50ms
     double baseInterval = 1000.0;
@@ -219,8 +462,33 @@ double Game::getDropInterval() const {
     return baseInterval * speedFactor;
 }
 
-void Game::lockTetromino() {
+template <int W, int H>
+int BasicGame<W, H>::getDropIntervalTicks() const {
+    return getDropIntervalTicks(level);
+}
+
+template <int W, int H>
+int BasicGame<W, H>::getDropIntervalTicks(int atLevel) {
+    double speedFactor = 1.0 - (atLevel - 1) * 0.1;
+    if (speedFactor < 0.05) speedFactor = 0.05;
+    return static_cast<int>(std::lround(1000.0 * speedFactor * TICKS_PER_SECOND / 1000.0));
+}
+
+template <int W, int H>
+int BasicGame<W, H>::getTicksUntilDrop() const {
+    int remaining = getDropIntervalTicks() - gravityTicks;
+    return remaining > 0 ? remaining : 0;
+}
+
+template <int W, int H>
+long long BasicGame<W, H>::getTickCount() const {
+    return tickCount;
+}
+
+template <int W, int H>
+void BasicGame<W, H>::lockTetromino() {
     board.place(currentTetromino, currentX, currentY);
+    ++piecesPlaced;
 
     int lines = board.clearLines();
     if (lines > 0) {
@@ -236,23 +504,27 @@ void Game::lockTetromino() {
     }
 }
 
-void Game::updateScore(int lines) {
+template <int W, int H>
+void BasicGame<W, H>::updateScore(int lines) {
     if (lines > 0 && lines <= 4) {
         score += BASE_SCORE_PER_LINE[lines] * level;
     }
 }
 
-void Game::updateLevel() {
+template <int W, int H>
+void BasicGame<W, H>::updateLevel() {
     int newLevel = (totalLinesCleared / LINES_PER_LEVEL) + 1;
     if (newLevel > level) {
         level = newLevel;
     }
 }
 
-int Game::calculateGhostY() const {
-    int ghostY = currentY;
-    while (board.canPlace(currentTetromino, currentX, ghostY + 1)) {
-        ++ghostY;
-    }
-    return ghostY;
+template <int W, int H>
+int BasicGame<W, H>::calculateGhostY() const {
+    return board.getLandingY(currentTetromino, currentX, currentY);
 }
+
+template class BasicGame<10, 20>;
+template class BasicGame<10, 40>;
+template class BasicGame<16, 20>;
+template class BasicGame<32, 20>;
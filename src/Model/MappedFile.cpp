@@ -0,0 +1,99 @@
+#include "../../include/Model/MappedFile.h"
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : bytes(nullptr)
+    , length(0)
+    , mapped(false)
+    , opened(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        error = "cannot read " + path;
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    // An empty file cannot be mapped, and needs no bytes anyway
+    if (length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            error = "cannot map " + path;
+            return false;
+        }
+        bytes = static_cast<const uint8_t*>(address);
+        mapped = true;
+    }
+    ::close(fd);
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + count);
+    }
+    bool readFailed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (readFailed) {
+        buffer.clear();
+        error = "cannot read " + path;
+        return false;
+    }
+    bytes = buffer.data();
+    length = buffer.size();
+#endif
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(bytes), length);
+    }
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    opened = false;
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+const uint8_t* MappedFile::data() const {
+    return bytes;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
@@ -0,0 +1,111 @@
+#include "../../include/Model/PieceGenerator.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+const char* const POLICY_NAMES[] = {"uniform", "7-bag", "14-bag"};
+}
+
+PieceGenerator::PieceGenerator(uint64_t seed, PiecePolicy policy, int previewDepth)
+    : rng(seed)
+    , policy(policy)
+    , previewDepth(1)
+    , head(0)
+    , count(0) {
+    setPreviewDepth(previewDepth);
+}
+
+void PieceGenerator::reseed(uint64_t seed, PiecePolicy newPolicy) {
+    rng.seed(seed);
+    policy = newPolicy;
+    head = 0;
+    count = 0;
+    refill();
+}
+
+PiecePolicy PieceGenerator::getPolicy() const {
+    return policy;
+}
+
+void PieceGenerator::setPreviewDepth(int depth) {
+    if (depth < 1) depth = 1;
+    if (depth > MAX_PREVIEW) depth = MAX_PREVIEW;
+    previewDepth = depth;
+    refill();
+}
+
+int PieceGenerator::getPreviewDepth() const {
+    return previewDepth;
+}
+
+void PieceGenerator::refill() {
+    // Keep one piece beyond the preview so next() never runs dry
+    const unsigned needed = static_cast<unsigned>(previewDepth) + 1;
+
+    while (count < needed) {
+        unsigned tail = (head + count) & MASK;
+
+        if (policy == PiecePolicy::UNIFORM) {
+            for (; count < CAPACITY; ++count) {
+                queue[tail] = Tetromino::createRandom(rng);
+                tail = (tail + 1) & MASK;
+            }
+            continue;
+        }
+
+        // Fisher-Yates over one bag, written straight into the ring
+        const int copies = policy == PiecePolicy::BAG_14 ? 2 : 1;
+        std::array<TetrominoType, PIECE_TYPES * 2> bag;
+        const int bagSize = PIECE_TYPES * copies;
+        for (int i = 0; i < bagSize; ++i) {
+            bag[i] = static_cast<TetrominoType>(i % PIECE_TYPES);
+        }
+        for (int i = bagSize - 1; i > 0; --i) {
+            int j = rng.nextInt(i + 1);
+            std::swap(bag[i], bag[j]);
+        }
+        for (int i = 0; i < bagSize; ++i) {
+            queue[tail] = Tetromino(bag[i]);
+            tail = (tail + 1) & MASK;
+        }
+        count += static_cast<unsigned>(bagSize);
+    }
+}
+
+PieceGenerator::Snapshot PieceGenerator::snapshot() const {
+    Snapshot snapshot;
+    snapshot.rng = rng;
+    snapshot.policy = policy;
+    snapshot.previewDepth = previewDepth;
+    snapshot.queuedCount = count;
+    for (unsigned i = 0; i < count; ++i) {
+        snapshot.queued[i] = queue[(head + i) & MASK];
+    }
+    return snapshot;
+}
+
+void PieceGenerator::restore(const Snapshot& snapshot) {
+    // Where the queue sits in the ring never affects the sequence
+    rng = snapshot.rng;
+    policy = snapshot.policy;
+    previewDepth = snapshot.previewDepth;
+    head = 0;
+    count = snapshot.queuedCount;
+    for (unsigned i = 0; i < count; ++i) {
+        queue[i] = snapshot.queued[i];
+    }
+}
+
+const char* PieceGenerator::getPolicyName(PiecePolicy policy) {
+    return POLICY_NAMES[static_cast<int>(policy)];
+}
+
+bool PieceGenerator::parsePolicy(const char* name, PiecePolicy& policy) {
+    for (int i = 0; i < 3; ++i) {
+        if (std::strcmp(name, POLICY_NAMES[i]) == 0) {
+            policy = static_cast<PiecePolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,24 @@
+#include "../../include/Model/Random.h"
+
+Random::Random(uint64_t seed) {
+    this->seed(seed);
+}
+
+void Random::seed(uint64_t seed) {
+    uint64_t mix = seed;
+    for (auto& word : state) {
+        word = splitMix64(mix);
+    }
+}
+
+void Random::getState(uint64_t words[4]) const {
+    for (int i = 0; i < 4; ++i) {
+        words[i] = state[i];
+    }
+}
+
+void Random::setState(const uint64_t words[4]) {
+    for (int i = 0; i < 4; ++i) {
+        state[i] = words[i];
+    }
+}
@@ -0,0 +1,302 @@
+#include "../../include/Model/Replay.h"
+#include "../../include/Model/MappedFile.h"
+#include "../../include/Model/ReplayArchive.h"
+#include <algorithm>
+#include <cstring>
+
+// File layout, all integers little-endian:
+//   header   "TTRP", u16 format version, u16 piece policy, u32 engine
+//            version, u64 seed
+//   body     per event: LEB128 tick delta since the previous event, u8 action
+//   trailer  u64 event count, u64 end tick, u64 pieces placed, u64 digest,
+//            i32 score, i32 lines cleared, i32 level, "TTRE"
+// Format 2 had no level in the trailer; it is worked out from the lines.
+namespace {
+const char HEADER_MAGIC[4] = {'T', 'T', 'R', 'P'};
+const char TRAILER_MAGIC[4] = {'T', 'T', 'R', 'E'};
+const size_t HEADER_SIZE = 20;
+const size_t TRAILER_SIZE = 48;
+const size_t TRAILER_SIZE_V2 = 44;
+const uint16_t OLDEST_FORMAT_VERSION = 2;
+const long long MAX_ADVANCE_TICKS = 1LL << 30;
+
+void putLE(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint64_t getLE(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// FNV-1a, fed one value at a time
+void mix(uint64_t& hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+}
+}
+
+bool Replay::load(const std::string& path, Replay& replay, std::string& error) {
+    MappedFile file;
+    if (!file.open(path, error)) {
+        return false;
+    }
+    // Archives carry the same events, in blocks
+    if (file.size() >= 4 && std::memcmp(file.data(), "TTRA", 4) == 0) {
+        ReplayArchive archive;
+        return archive.open(path, error) && archive.readReplay(replay, error);
+    }
+    return parse(file.data(), file.size(), path, replay, error);
+}
+
+bool Replay::parse(const uint8_t* data, size_t size, const std::string& path, Replay& replay, std::string& error) {
+    if (size < HEADER_SIZE + TRAILER_SIZE_V2 ||
+        std::memcmp(data, HEADER_MAGIC, 4) != 0 ||
+        std::memcmp(data + size - 4, TRAILER_MAGIC, 4) != 0) {
+        error = path + " is not a replay file";
+        return false;
+    }
+    uint64_t version = getLE(data + 4, 2);
+    if (version < OLDEST_FORMAT_VERSION || version > FORMAT_VERSION) {
+        error = path + " uses an unsupported replay format";
+        return false;
+    }
+    const size_t trailerSize = version == OLDEST_FORMAT_VERSION ? TRAILER_SIZE_V2 : TRAILER_SIZE;
+    if (size < HEADER_SIZE + trailerSize) {
+        error = path + " is not a replay file";
+        return false;
+    }
+
+    uint64_t policy = getLE(data + 6, 2);
+    if (policy > static_cast<uint64_t>(PiecePolicy::BAG_14)) {
+        error = path + " uses an unknown piece policy";
+        return false;
+    }
+    replay.piecePolicy = static_cast<PiecePolicy>(policy);
+    replay.engineVersion = static_cast<uint32_t>(getLE(data + 8, 4));
+    replay.seed = getLE(data + 12, 8);
+    if (replay.engineVersion != Game::ENGINE_VERSION) {
+        error = path + " was recorded with engine version " + std::to_string(replay.engineVersion) +
+                ", this build is version " + std::to_string(Game::ENGINE_VERSION);
+        return false;
+    }
+
+    const uint8_t* trailer = data + size - trailerSize;
+    uint64_t eventCount = getLE(trailer, 8);
+    replay.summary.endTick = static_cast<long long>(getLE(trailer + 8, 8));
+    replay.summary.piecesPlaced = static_cast<long long>(getLE(trailer + 16, 8));
+    replay.summary.digest = getLE(trailer + 24, 8);
+    replay.summary.score = static_cast<int32_t>(getLE(trailer + 32, 4));
+    replay.summary.linesCleared = static_cast<int32_t>(getLE(trailer + 36, 4));
+    replay.summary.level = version == OLDEST_FORMAT_VERSION
+        ? replay.summary.linesCleared / Game::LINES_PER_LEVEL + 1
+        : static_cast<int32_t>(getLE(trailer + 40, 4));
+
+    // Every event takes at least two bytes, which bounds the count before
+    // anything is allocated for it
+    const uint8_t* in = data + HEADER_SIZE;
+    const uint8_t* end = trailer;
+    if (eventCount > static_cast<uint64_t>(end - in) / 2) {
+        error = path + " is truncated";
+        return false;
+    }
+    replay.events.clear();
+    replay.events.reserve(static_cast<size_t>(eventCount));
+
+    long long tick = 0;
+    for (uint64_t i = 0; i < eventCount; ++i) {
+        uint64_t delta = 0;
+        int shift = 0;
+        while (in < end && (*in & 0x80) && shift < 63) {
+            delta |= static_cast<uint64_t>(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        if (in + 2 > end || *in & 0x80 || in[1] > static_cast<uint8_t>(InputAction::RESTART)) {
+            error = path + " is corrupt at event " + std::to_string(i);
+            return false;
+        }
+        delta |= static_cast<uint64_t>(*in++) << shift;
+        tick += static_cast<long long>(delta);
+        replay.events.push_back({tick, static_cast<InputAction>(*in++)});
+    }
+    if (in != end || tick > replay.summary.endTick) {
+        error = path + " is corrupt";
+        return false;
+    }
+    return true;
+}
+
+uint64_t Replay::digest(const Game& game) {
+    uint64_t hash = 14695981039346656037ULL;
+    const Board& board = game.getBoard();
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        mix(hash, board.getRow(y));
+    }
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        for (uint8_t cell : board.getColorRow(y)) {
+            hash = (hash ^ cell) * 1099511628211ULL;
+        }
+    }
+    mix(hash, static_cast<uint64_t>(game.getCurrentTetromino().getType()));
+    mix(hash, static_cast<uint64_t>(game.getCurrentTetromino().getRotationState()));
+    mix(hash, static_cast<uint64_t>(game.getNextTetromino().getType()));
+    mix(hash, static_cast<uint64_t>(game.getCurrentX()));
+    mix(hash, static_cast<uint64_t>(game.getCurrentY()));
+    mix(hash, static_cast<uint64_t>(game.getScore()));
+    mix(hash, static_cast<uint64_t>(game.getLevel()));
+    mix(hash, static_cast<uint64_t>(game.getLinesCleared()));
+    mix(hash, static_cast<uint64_t>(game.getPiecesPlaced()));
+    mix(hash, static_cast<uint64_t>(game.getState()));
+    mix(hash, static_cast<uint64_t>(game.getTickCount()));
+    mix(hash, static_cast<uint64_t>(game.getTicksUntilDrop()));
+    return hash;
+}
+
+void Replay::advance(Game& game, long long ticks) {
+    while (ticks > 0 && game.getState() == GameState::PLAYING) {
+        long long span = std::min(ticks, MAX_ADVANCE_TICKS);
+        game.advance(static_cast<int>(span));
+        ticks -= span;
+    }
+}
+
+ReplayRecorder::ReplayRecorder(uint64_t seed, PiecePolicy piecePolicy)
+    : seed(seed)
+    , piecePolicy(piecePolicy)
+    , tick(0)
+    , lastEventTick(0)
+    , eventCount(0) {
+    body.reserve(INITIAL_CAPACITY);
+}
+
+void ReplayRecorder::record(InputAction action) {
+    uint64_t delta = static_cast<uint64_t>(tick - lastEventTick);
+    while (delta >= 0x80) {
+        body.push_back(static_cast<uint8_t>(delta | 0x80));
+        delta >>= 7;
+    }
+    body.push_back(static_cast<uint8_t>(delta));
+    body.push_back(static_cast<uint8_t>(action));
+    lastEventTick = tick;
+    ++eventCount;
+}
+
+void ReplayRecorder::advance(int ticks) {
+    if (ticks > 0) {
+        tick += ticks;
+    }
+}
+
+long long ReplayRecorder::getTick() const {
+    return tick;
+}
+
+size_t ReplayRecorder::getEventCount() const {
+    return eventCount;
+}
+
+bool ReplayRecorder::save(const std::string& path, const Game& finalState, std::string& error) const {
+    std::vector<uint8_t> header;
+    header.insert(header.end(), HEADER_MAGIC, HEADER_MAGIC + 4);
+    putLE(header, Replay::FORMAT_VERSION, 2);
+    putLE(header, static_cast<uint64_t>(piecePolicy), 2);
+    putLE(header, Game::ENGINE_VERSION, 4);
+    putLE(header, seed, 8);
+
+    std::vector<uint8_t> trailer;
+    putLE(trailer, eventCount, 8);
+    putLE(trailer, static_cast<uint64_t>(tick), 8);
+    putLE(trailer, static_cast<uint64_t>(finalState.getPiecesPlaced()), 8);
+    putLE(trailer, Replay::digest(finalState), 8);
+    putLE(trailer, static_cast<uint32_t>(finalState.getScore()), 4);
+    putLE(trailer, static_cast<uint32_t>(finalState.getLinesCleared()), 4);
+    putLE(trailer, static_cast<uint32_t>(finalState.getLevel()), 4);
+    trailer.insert(trailer.end(), TRAILER_MAGIC, TRAILER_MAGIC + 4);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    bool written = std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+                   std::fwrite(body.data(), 1, body.size(), file) == body.size() &&
+                   std::fwrite(trailer.data(), 1, trailer.size(), file) == trailer.size();
+    if (std::fclose(file) != 0 || !written) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay& replay, Game& game)
+    : replay(replay)
+    , game(game)
+    , nextEvent(0)
+    , tick(0) {
+    game.setSeed(replay.seed);
+    game.setPiecePolicy(replay.piecePolicy);
+}
+
+void ReplayPlayer::advanceTo(long long target) {
+    if (target > replay.summary.endTick) {
+        target = replay.summary.endTick;
+    }
+    size_t event = nextEvent;
+    while (event < replay.events.size() && replay.events[event].tick <= target) {
+        ++event;
+    }
+    playUntil(event, target);
+}
+
+void ReplayPlayer::playUntil(size_t event, long long target) {
+    event = std::min(event, replay.events.size());
+    while (nextEvent < event) {
+        const ReplayEvent& next = replay.events[nextEvent++];
+        Replay::advance(game, next.tick - tick);
+        tick = next.tick;
+        game.applyAction(next.action);
+    }
+    if (target > tick) {
+        Replay::advance(game, target - tick);
+        tick = target;
+    }
+}
+
+void ReplayPlayer::runToEnd() {
+    advanceTo(replay.summary.endTick);
+}
+
+long long ReplayPlayer::getTick() const {
+    return tick;
+}
+
+size_t ReplayPlayer::getPlayedEvents() const {
+    return nextEvent;
+}
+
+long long ReplayPlayer::getNextEventTick() const {
+    if (nextEvent < replay.events.size()) {
+        return replay.events[nextEvent].tick;
+    }
+    return replay.summary.endTick;
+}
+
+bool ReplayPlayer::isFinished() const {
+    return nextEvent == replay.events.size() && tick >= replay.summary.endTick;
+}
+
+bool ReplayPlayer::matchesRecording() const {
+    return isFinished() &&
+           game.getScore() == replay.summary.score &&
+           game.getLevel() == replay.summary.level &&
+           game.getLinesCleared() == replay.summary.linesCleared &&
+           game.getPiecesPlaced() == replay.summary.piecesPlaced &&
+           Replay::digest(game) == replay.summary.digest;
+}
@@ -0,0 +1,703 @@
+#include "../../include/Model/ReplayArchive.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// File layout, all integers little-endian:
+//   header   "TTRA", u16 format version, u16 piece policy, u32 engine
+//            version, u64 seed, u32 keyframe interval
+//   blocks   one per keyframe, each compressed on its own (see compress())
+//            from: the game snapshot, then per event a LEB128 of the tick
+//            delta since the previous event (or the keyframe) shifted left
+//            by four with the action in the low bits
+//   index    per keyframe: u64 block offset, u32 compressed size, u32 raw
+//            size, u64 tick, u64 pieces, u64 first event, u32 event count
+//   trailer  u64 keyframe count, u64 index offset, u64 event count, u64 end
+//            tick, u64 session pieces, u64 pieces placed, u64 digest, i32
+//            score, i32 lines cleared, i32 level, "TTAE"
+namespace {
+const char HEADER_MAGIC[4] = {'T', 'T', 'R', 'A'};
+const char TRAILER_MAGIC[4] = {'T', 'T', 'A', 'E'};
+const size_t HEADER_SIZE = 24;
+const size_t INDEX_ENTRY_SIZE = 44;
+const size_t TRAILER_SIZE = 72;
+
+const int ACTION_BITS = 4;
+static_assert(static_cast<int>(InputAction::TOGGLE_STATS) < (1 << ACTION_BITS), "actions fit the low bits");
+
+// A block also closes once this much has been written to it, so a long
+// stretch without pieces (a paused game, the menu) still gets keyframes
+const size_t MAX_BLOCK_BYTES = 64 * 1024;
+// The longest event: a ten-byte LEB128
+const size_t MAX_EVENT_BYTES = 10;
+
+const size_t SNAPSHOT_SIZE = Board::HEIGHT * Board::WIDTH + 1 + 2 + 12 + 16 + 4 + 1 + 8 + 2 + 32 + 3 +
+                             PieceGenerator::CAPACITY;
+
+void putLE(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint64_t getLE(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// An archive with a single keyframe has no finished blocks, and an empty
+// vector's data() may be null, which fwrite must not be given
+bool writeAll(std::FILE* file, const std::vector<uint8_t>& bytes) {
+    return bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
+
+bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Type in the low nibble, rotation in the high one
+uint8_t packPiece(const Tetromino& piece) {
+    return static_cast<uint8_t>(static_cast<int>(piece.getType()) | piece.getRotationState() << 4);
+}
+
+bool unpackPiece(uint8_t packed, Tetromino& piece) {
+    int type = packed & 0x0F;
+    int rotation = packed >> 4;
+    if (type > static_cast<int>(TetrominoType::NONE) || rotation >= PIECE_ROTATIONS) {
+        return false;
+    }
+    piece = Tetromino(static_cast<TetrominoType>(type));
+    for (int i = 0; i < rotation; ++i) {
+        piece.rotate();
+    }
+    return true;
+}
+
+void putSnapshot(std::vector<uint8_t>& out, const Game::Snapshot& snapshot) {
+    for (const auto& row : snapshot.cells) {
+        out.insert(out.end(), row.begin(), row.end());
+    }
+    out.push_back(packPiece(snapshot.current));
+    out.push_back(static_cast<uint8_t>(snapshot.x));
+    out.push_back(static_cast<uint8_t>(snapshot.y));
+    putLE(out, static_cast<uint32_t>(snapshot.score), 4);
+    putLE(out, static_cast<uint32_t>(snapshot.level), 4);
+    putLE(out, static_cast<uint32_t>(snapshot.linesCleared), 4);
+    putLE(out, static_cast<uint64_t>(snapshot.piecesPlaced), 8);
+    putLE(out, static_cast<uint64_t>(snapshot.tickCount), 8);
+    putLE(out, static_cast<uint32_t>(snapshot.gravityTicks), 4);
+    out.push_back(static_cast<uint8_t>(snapshot.state));
+    putLE(out, snapshot.seed, 8);
+    out.push_back(static_cast<uint8_t>(snapshot.piecePolicy));
+    out.push_back(snapshot.reseedPending ? 1 : 0);
+
+    uint64_t words[4];
+    snapshot.pieces.rng.getState(words);
+    for (uint64_t word : words) {
+        putLE(out, word, 8);
+    }
+    out.push_back(static_cast<uint8_t>(snapshot.pieces.policy));
+    out.push_back(static_cast<uint8_t>(snapshot.pieces.previewDepth));
+    out.push_back(static_cast<uint8_t>(snapshot.pieces.queuedCount));
+    for (unsigned i = 0; i < PieceGenerator::CAPACITY; ++i) {
+        out.push_back(i < snapshot.pieces.queuedCount ? packPiece(snapshot.pieces.queued[i]) : 0);
+    }
+}
+
+// Reads SNAPSHOT_SIZE bytes, rejecting anything Game could not have been in
+bool getSnapshot(const uint8_t* in, Game::Snapshot& snapshot) {
+    for (auto& row : snapshot.cells) {
+        for (uint8_t& cell : row) {
+            if (*in > PIECE_TYPES) {
+                return false;
+            }
+            cell = *in++;
+        }
+    }
+    if (!unpackPiece(in[0], snapshot.current)) {
+        return false;
+    }
+    snapshot.x = static_cast<int8_t>(in[1]);
+    snapshot.y = static_cast<int8_t>(in[2]);
+    in += 3;
+    snapshot.score = static_cast<int32_t>(getLE(in, 4));
+    snapshot.level = static_cast<int32_t>(getLE(in + 4, 4));
+    snapshot.linesCleared = static_cast<int32_t>(getLE(in + 8, 4));
+    snapshot.piecesPlaced = static_cast<long long>(getLE(in + 12, 8));
+    snapshot.tickCount = static_cast<long long>(getLE(in + 20, 8));
+    snapshot.gravityTicks = static_cast<int32_t>(getLE(in + 28, 4));
+    uint8_t state = in[32];
+    snapshot.seed = getLE(in + 33, 8);
+    uint8_t policy = in[41];
+    snapshot.reseedPending = in[42] != 0;
+    in += 43;
+
+    uint64_t words[4];
+    for (uint64_t& word : words) {
+        word = getLE(in, 8);
+        in += 8;
+    }
+    snapshot.pieces.rng.setState(words);
+    uint8_t queuePolicy = in[0];
+    snapshot.pieces.previewDepth = in[1];
+    snapshot.pieces.queuedCount = in[2];
+    in += 3;
+    for (unsigned i = 0; i < PieceGenerator::CAPACITY; ++i) {
+        if (!unpackPiece(in[i], snapshot.pieces.queued[i])) {
+            return false;
+        }
+    }
+
+    const int maxPolicy = static_cast<int>(PiecePolicy::BAG_14);
+    if (state > static_cast<int>(GameState::GAME_OVER) || policy > maxPolicy || queuePolicy > maxPolicy ||
+        snapshot.x <= -Tetromino::MATRIX_SIZE || snapshot.x >= Board::WIDTH ||
+        snapshot.y < -Tetromino::MATRIX_SIZE || snapshot.y >= Board::HEIGHT || snapshot.level < 1 ||
+        snapshot.gravityTicks < 0 || snapshot.pieces.previewDepth < 1 ||
+        snapshot.pieces.previewDepth > PieceGenerator::MAX_PREVIEW ||
+        snapshot.pieces.queuedCount > PieceGenerator::CAPACITY) {
+        return false;
+    }
+    snapshot.state = static_cast<GameState>(state);
+    snapshot.piecePolicy = static_cast<PiecePolicy>(policy);
+    snapshot.pieces.policy = static_cast<PiecePolicy>(queuePolicy);
+    return true;
+}
+
+// Byte-oriented LZ77. A block is a run of sequences, each a token byte
+// (literal count in the high nibble, match length minus MIN_MATCH in the
+// low one, 15 meaning more follows as bytes summed until one is below 255),
+// the literals, then a u16 match offset. The last sequence stops after its
+// literals. Snapshots are mostly empty cells and play falls into patterns
+// of moves, which is what this catches; a block decodes in microseconds.
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 0xFFFF;
+const int HASH_BITS = 12;
+
+uint32_t load32(const uint8_t* in) {
+    uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+void putLength(std::vector<uint8_t>& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void putSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset,
+                 size_t matchLength) {
+    size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+    out.push_back(static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4 | std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15) {
+        putLength(out, literalCount - 15);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+    if (matchLength == 0) {
+        return;
+    }
+    putLE(out, offset, 2);
+    if (matchCode >= 15) {
+        putLength(out, matchCode - 15);
+    }
+}
+
+void compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    std::vector<int32_t> table(size_t(1) << HASH_BITS, -1);
+    size_t literalStart = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= size) {
+        uint32_t sequence = load32(in + pos);
+        uint32_t slot = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        int32_t candidate = table[slot];
+        table[slot] = static_cast<int32_t>(pos);
+        if (candidate < 0 || pos - static_cast<size_t>(candidate) > MAX_OFFSET ||
+            load32(in + candidate) != sequence) {
+            ++pos;
+            continue;
+        }
+        size_t length = MIN_MATCH;
+        while (pos + length < size && in[candidate + length] == in[pos + length]) {
+            ++length;
+        }
+        putSequence(out, in + literalStart, pos - literalStart, pos - static_cast<size_t>(candidate), length);
+        pos += length;
+        literalStart = pos;
+    }
+    putSequence(out, in + literalStart, size - literalStart, 0, 0);
+}
+
+bool getLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Fills out[0, rawSize) exactly from exactly `size` bytes
+bool decompress(const uint8_t* in, size_t size, uint8_t* out, size_t rawSize) {
+    const uint8_t* end = in + size;
+    size_t written = 0;
+    while (in < end) {
+        uint8_t token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !getLength(in, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - in) || literalCount > rawSize - written) {
+            return false;
+        }
+        std::memcpy(out + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+        if (in == end) {
+            return written == rawSize;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(getLE(in, 2));
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !getLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > written || matchLength > rawSize - written) {
+            return false;
+        }
+        // Byte by byte, since a match may overlap what it is copying
+        for (size_t i = 0; i < matchLength; ++i, ++written) {
+            out[written] = out[written - offset];
+        }
+    }
+    return false;
+}
+
+// Adds the pieces locked since `lastPlaced` was taken to the session's
+// count; a restart puts the game's own count back to zero
+void countPieces(const Game& game, long long& lastPlaced, long long& pieces) {
+    long long placed = game.getPiecesPlaced();
+    pieces += placed >= lastPlaced ? placed - lastPlaced : placed;
+    lastPlaced = placed;
+}
+}
+
+ReplayArchive::ReplayArchive()
+    : seed(0)
+    , piecePolicy(PiecePolicy::UNIFORM)
+    , keyframeInterval(DEFAULT_KEYFRAME_INTERVAL)
+    , eventCount(0)
+    , pieceCount(0) {
+}
+
+bool ReplayArchive::open(const std::string& filePath, std::string& error) {
+    path = filePath;
+    keyframes.clear();
+    if (!file.open(path, error)) {
+        return false;
+    }
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    if (size < HEADER_SIZE + TRAILER_SIZE || std::memcmp(data, HEADER_MAGIC, 4) != 0 ||
+        std::memcmp(data + size - 4, TRAILER_MAGIC, 4) != 0) {
+        error = path + " is not a replay archive";
+        return false;
+    }
+    if (getLE(data + 4, 2) != FORMAT_VERSION) {
+        error = path + " uses an unsupported archive format";
+        return false;
+    }
+    uint64_t policy = getLE(data + 6, 2);
+    if (policy > static_cast<uint64_t>(PiecePolicy::BAG_14)) {
+        error = path + " uses an unknown piece policy";
+        return false;
+    }
+    piecePolicy = static_cast<PiecePolicy>(policy);
+    uint32_t engineVersion = static_cast<uint32_t>(getLE(data + 8, 4));
+    if (engineVersion != Game::ENGINE_VERSION) {
+        error = path + " was recorded with engine version " + std::to_string(engineVersion) +
+                ", this build is version " + std::to_string(Game::ENGINE_VERSION);
+        return false;
+    }
+    seed = getLE(data + 12, 8);
+    keyframeInterval = static_cast<int>(getLE(data + 20, 4));
+
+    const uint8_t* trailer = data + size - TRAILER_SIZE;
+    uint64_t keyframeCount = getLE(trailer, 8);
+    uint64_t indexOffset = getLE(trailer + 8, 8);
+    eventCount = static_cast<long long>(getLE(trailer + 16, 8));
+    summary.endTick = static_cast<long long>(getLE(trailer + 24, 8));
+    pieceCount = static_cast<long long>(getLE(trailer + 32, 8));
+    summary.piecesPlaced = static_cast<long long>(getLE(trailer + 40, 8));
+    summary.digest = getLE(trailer + 48, 8);
+    summary.score = static_cast<int32_t>(getLE(trailer + 56, 4));
+    summary.linesCleared = static_cast<int32_t>(getLE(trailer + 60, 4));
+    summary.level = static_cast<int32_t>(getLE(trailer + 64, 4));
+
+    // The index has to fill the space between the blocks and the trailer
+    const uint64_t indexEnd = size - TRAILER_SIZE;
+    if (keyframeCount == 0 || indexOffset < HEADER_SIZE || indexOffset > indexEnd ||
+        (indexEnd - indexOffset) / INDEX_ENTRY_SIZE != keyframeCount ||
+        (indexEnd - indexOffset) % INDEX_ENTRY_SIZE != 0) {
+        error = path + " has a corrupt index";
+        return false;
+    }
+
+    keyframes.reserve(static_cast<size_t>(keyframeCount));
+    uint64_t blockOffset = HEADER_SIZE;
+    long long events = 0;
+    for (uint64_t i = 0; i < keyframeCount; ++i) {
+        const uint8_t* in = data + indexOffset + i * INDEX_ENTRY_SIZE;
+        ReplayKeyframe keyframe;
+        keyframe.offset = getLE(in, 8);
+        keyframe.compressedSize = static_cast<uint32_t>(getLE(in + 8, 4));
+        keyframe.rawSize = static_cast<uint32_t>(getLE(in + 12, 4));
+        keyframe.tick = static_cast<long long>(getLE(in + 16, 8));
+        keyframe.pieces = static_cast<long long>(getLE(in + 24, 8));
+        keyframe.firstEvent = static_cast<long long>(getLE(in + 32, 8));
+        keyframe.eventCount = static_cast<uint32_t>(getLE(in + 40, 4));
+
+        // Blocks sit back to back in keyframe order, and ticks, pieces and
+        // events only go forward
+        bool ordered = keyframes.empty() ? keyframe.tick == 0 && keyframe.pieces == 0
+                                         : keyframe.tick >= keyframes.back().tick &&
+                                           keyframe.pieces >= keyframes.back().pieces;
+        if (!ordered || keyframe.offset != blockOffset || keyframe.compressedSize > indexOffset - blockOffset ||
+            keyframe.rawSize < SNAPSHOT_SIZE || keyframe.rawSize > SNAPSHOT_SIZE + MAX_BLOCK_BYTES + MAX_EVENT_BYTES ||
+            keyframe.firstEvent != events || keyframe.tick > summary.endTick || keyframe.pieces > pieceCount) {
+            error = path + " has a corrupt index at keyframe " + std::to_string(i);
+            return false;
+        }
+        blockOffset += keyframe.compressedSize;
+        events += keyframe.eventCount;
+        keyframes.push_back(keyframe);
+    }
+    if (blockOffset != indexOffset || events != eventCount) {
+        error = path + " has a corrupt index";
+        return false;
+    }
+    return true;
+}
+
+uint64_t ReplayArchive::getSeed() const {
+    return seed;
+}
+
+PiecePolicy ReplayArchive::getPiecePolicy() const {
+    return piecePolicy;
+}
+
+int ReplayArchive::getKeyframeInterval() const {
+    return keyframeInterval;
+}
+
+const std::vector<ReplayKeyframe>& ReplayArchive::getKeyframes() const {
+    return keyframes;
+}
+
+long long ReplayArchive::getEventCount() const {
+    return eventCount;
+}
+
+long long ReplayArchive::getPieceCount() const {
+    return pieceCount;
+}
+
+const ReplaySummary& ReplayArchive::getSummary() const {
+    return summary;
+}
+
+long long ReplayArchive::getBlockEndTick(size_t i) const {
+    return i + 1 < keyframes.size() ? keyframes[i + 1].tick : summary.endTick;
+}
+
+bool ReplayArchive::readBlock(size_t i, Game::Snapshot& snapshot, std::vector<ReplayEvent>& events,
+                              std::string& error) const {
+    if (i >= keyframes.size()) {
+        error = path + " has " + std::to_string(keyframes.size()) + " keyframes";
+        return false;
+    }
+    const ReplayKeyframe& keyframe = keyframes[i];
+    std::vector<uint8_t> raw(keyframe.rawSize);
+    if (!decompress(file.data() + keyframe.offset, keyframe.compressedSize, raw.data(), raw.size()) ||
+        !getSnapshot(raw.data(), snapshot)) {
+        error = path + " is corrupt at keyframe " + std::to_string(i);
+        return false;
+    }
+
+    const uint8_t* in = raw.data() + SNAPSHOT_SIZE;
+    const uint8_t* end = raw.data() + raw.size();
+    const long long endTick = getBlockEndTick(i);
+    long long tick = keyframe.tick;
+    events.clear();
+    events.reserve(keyframe.eventCount);
+    for (uint32_t n = 0; n < keyframe.eventCount; ++n) {
+        uint64_t value;
+        if (!getVarint(in, end, value) ||
+            (value & ((1u << ACTION_BITS) - 1)) > static_cast<uint64_t>(InputAction::RESTART) ||
+            static_cast<long long>(value >> ACTION_BITS) > endTick - tick) {
+            error = path + " is corrupt at event " + std::to_string(keyframe.firstEvent + n);
+            return false;
+        }
+        tick += static_cast<long long>(value >> ACTION_BITS);
+        events.push_back({tick, static_cast<InputAction>(value & ((1u << ACTION_BITS) - 1))});
+    }
+    if (in != end) {
+        error = path + " is corrupt at keyframe " + std::to_string(i);
+        return false;
+    }
+    return true;
+}
+
+bool ReplayArchive::seekToPiece(long long piece, Game& game, long long& tick, std::string& error) const {
+    if (piece < 0 || piece > pieceCount) {
+        error = "the session has " + std::to_string(pieceCount) + " pieces";
+        return false;
+    }
+    // The newest keyframe taken before that piece locked, so the lock
+    // itself is played; piece 0 is the first keyframe
+    size_t block = 0;
+    if (piece > 0) {
+        auto after = std::partition_point(keyframes.begin(), keyframes.end(),
+                                          [piece](const ReplayKeyframe& k) { return k.pieces < piece; });
+        block = static_cast<size_t>(after - keyframes.begin()) - 1;
+    }
+
+    Game::Snapshot snapshot;
+    std::vector<ReplayEvent> events;
+    if (!readBlock(block, snapshot, events, error)) {
+        return false;
+    }
+    game.restore(snapshot);
+    tick = keyframes[block].tick;
+    long long pieces = keyframes[block].pieces;
+    long long lastPlaced = game.getPiecesPlaced();
+
+    // Gravity locks at most one piece per drop, so advancing a drop at a
+    // time stops on the lock itself
+    auto advanceTo = [&](long long target) {
+        while (tick < target && pieces < piece) {
+            long long span = target - tick;
+            if (game.getState() == GameState::PLAYING) {
+                span = std::min<long long>(span, std::max(1, game.getTicksUntilDrop()));
+            }
+            game.advance(static_cast<int>(span));
+            tick += span;
+            countPieces(game, lastPlaced, pieces);
+        }
+    };
+    for (const ReplayEvent& event : events) {
+        if (pieces >= piece) {
+            break;
+        }
+        advanceTo(event.tick);
+        if (pieces >= piece) {
+            break;
+        }
+        game.applyAction(event.action);
+        countPieces(game, lastPlaced, pieces);
+    }
+    advanceTo(getBlockEndTick(block));
+    if (pieces < piece) {
+        error = path + " is corrupt at keyframe " + std::to_string(block);
+        return false;
+    }
+    return true;
+}
+
+bool ReplayArchive::seekToTick(long long tick, Game& game, std::string& error) const {
+    tick = std::max(0LL, std::min(tick, summary.endTick));
+    auto after = std::partition_point(keyframes.begin(), keyframes.end(),
+                                      [tick](const ReplayKeyframe& k) { return k.tick <= tick; });
+    size_t block = static_cast<size_t>(after - keyframes.begin()) - 1;
+
+    Game::Snapshot snapshot;
+    std::vector<ReplayEvent> events;
+    if (!readBlock(block, snapshot, events, error)) {
+        return false;
+    }
+    game.restore(snapshot);
+    long long now = keyframes[block].tick;
+    for (const ReplayEvent& event : events) {
+        if (event.tick > tick) {
+            break;
+        }
+        Replay::advance(game, event.tick - now);
+        now = event.tick;
+        game.applyAction(event.action);
+    }
+    Replay::advance(game, tick - now);
+    return true;
+}
+
+bool ReplayArchive::readReplay(Replay& replay, std::string& error) const {
+    replay.seed = seed;
+    replay.piecePolicy = piecePolicy;
+    replay.engineVersion = Game::ENGINE_VERSION;
+    replay.summary = summary;
+    replay.events.clear();
+    replay.events.reserve(static_cast<size_t>(eventCount));
+
+    Game::Snapshot snapshot;
+    std::vector<ReplayEvent> events;
+    for (size_t i = 0; i < keyframes.size(); ++i) {
+        if (!readBlock(i, snapshot, events, error)) {
+            return false;
+        }
+        replay.events.insert(replay.events.end(), events.begin(), events.end());
+    }
+    return true;
+}
+
+ReplayArchiveWriter::ReplayArchiveWriter(const Game& game, int keyframeInterval)
+    : game(game)
+    , seed(game.getSeed())
+    , piecePolicy(game.getPiecePolicy())
+    , keyframeInterval(std::max(1, keyframeInterval))
+    , tick(0)
+    , lastEventTick(0)
+    , eventCount(0)
+    , pieces(0)
+    , lastPiecesPlaced(game.getPiecesPlaced())
+    , nextKeyframePieces(this->keyframeInterval) {
+    beginBlock();
+}
+
+void ReplayArchiveWriter::record(InputAction action) {
+    putVarint(openBlock, static_cast<uint64_t>(tick - lastEventTick) << ACTION_BITS | static_cast<uint64_t>(action));
+    lastEventTick = tick;
+    ++eventCount;
+    ++keyframes.back().eventCount;
+    observe();
+}
+
+void ReplayArchiveWriter::advance(long long ticks) {
+    if (ticks > 0) {
+        tick += ticks;
+    }
+    observe();
+}
+
+long long ReplayArchiveWriter::getTick() const {
+    return tick;
+}
+
+size_t ReplayArchiveWriter::getEventCount() const {
+    return eventCount;
+}
+
+size_t ReplayArchiveWriter::getKeyframeCount() const {
+    return keyframes.size();
+}
+
+void ReplayArchiveWriter::observe() {
+    countPieces(game, lastPiecesPlaced, pieces);
+    if (pieces >= nextKeyframePieces || openBlock.size() - SNAPSHOT_SIZE >= MAX_BLOCK_BYTES) {
+        closeBlock();
+        beginBlock();
+        nextKeyframePieces = (pieces / keyframeInterval + 1) * keyframeInterval;
+    }
+}
+
+void ReplayArchiveWriter::beginBlock() {
+    ReplayKeyframe keyframe = {};
+    keyframe.tick = tick;
+    keyframe.pieces = pieces;
+    keyframe.firstEvent = static_cast<long long>(eventCount);
+    keyframes.push_back(keyframe);
+
+    openBlock.clear();
+    putSnapshot(openBlock, game.snapshot());
+    lastEventTick = tick;
+}
+
+void ReplayArchiveWriter::closeBlock() {
+    ReplayKeyframe& keyframe = keyframes.back();
+    size_t start = blocks.size();
+    compress(openBlock.data(), openBlock.size(), blocks);
+    keyframe.offset = HEADER_SIZE + start;
+    keyframe.compressedSize = static_cast<uint32_t>(blocks.size() - start);
+    keyframe.rawSize = static_cast<uint32_t>(openBlock.size());
+}
+
+bool ReplayArchiveWriter::save(const std::string& path, std::string& error) const {
+    std::vector<uint8_t> header;
+    header.insert(header.end(), HEADER_MAGIC, HEADER_MAGIC + 4);
+    putLE(header, ReplayArchive::FORMAT_VERSION, 2);
+    putLE(header, static_cast<uint64_t>(piecePolicy), 2);
+    putLE(header, Game::ENGINE_VERSION, 4);
+    putLE(header, seed, 8);
+    putLE(header, static_cast<uint64_t>(keyframeInterval), 4);
+
+    // The open block is compressed here without closing it, so recording
+    // can go on after a save
+    std::vector<uint8_t> lastBlock;
+    compress(openBlock.data(), openBlock.size(), lastBlock);
+    std::vector<ReplayKeyframe> index = keyframes;
+    index.back().offset = HEADER_SIZE + blocks.size();
+    index.back().compressedSize = static_cast<uint32_t>(lastBlock.size());
+    index.back().rawSize = static_cast<uint32_t>(openBlock.size());
+
+    std::vector<uint8_t> trailer;
+    for (const ReplayKeyframe& keyframe : index) {
+        putLE(trailer, keyframe.offset, 8);
+        putLE(trailer, keyframe.compressedSize, 4);
+        putLE(trailer, keyframe.rawSize, 4);
+        putLE(trailer, static_cast<uint64_t>(keyframe.tick), 8);
+        putLE(trailer, static_cast<uint64_t>(keyframe.pieces), 8);
+        putLE(trailer, static_cast<uint64_t>(keyframe.firstEvent), 8);
+        putLE(trailer, keyframe.eventCount, 4);
+    }
+    putLE(trailer, index.size(), 8);
+    putLE(trailer, HEADER_SIZE + blocks.size() + lastBlock.size(), 8);
+    putLE(trailer, eventCount, 8);
+    putLE(trailer, static_cast<uint64_t>(tick), 8);
+    putLE(trailer, static_cast<uint64_t>(pieces), 8);
+    putLE(trailer, static_cast<uint64_t>(game.getPiecesPlaced()), 8);
+    putLE(trailer, Replay::digest(game), 8);
+    putLE(trailer, static_cast<uint32_t>(game.getScore()), 4);
+    putLE(trailer, static_cast<uint32_t>(game.getLinesCleared()), 4);
+    putLE(trailer, static_cast<uint32_t>(game.getLevel()), 4);
+    trailer.insert(trailer.end(), TRAILER_MAGIC, TRAILER_MAGIC + 4);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    bool written = writeAll(file, header) && writeAll(file, blocks) && writeAll(file, lastBlock) &&
+                   writeAll(file, trailer);
+    if (std::fclose(file) != 0 || !written) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#include "../../include/Server/Broadcaster.h"
+#include <algorithm>
+#include <limits>
+
+Broadcaster::Broadcaster(int boardWidth, int boardHeight, uint64_t now)
+    : renderer(boardWidth, boardHeight, -1)
+    , lastChangeCount(0)
+    , lastFrameTime(0)
+    , lastKeyframeTime(now)
+    , keyframeRequested(true)
+    , catchUpRequested(false)
+    , frameCount(0)
+    , keyframeCount(0) {
+    renderer.setOutbox(&outbox);
+}
+
+void Broadcaster::requestKeyframe() {
+    keyframeRequested = true;
+}
+
+void Broadcaster::requestCatchUp() {
+    catchUpRequested = true;
+}
+
+BroadcastFramePtr Broadcaster::poll(const Game& game, uint64_t changeCount, uint64_t now) {
+    bool changed = changeCount != lastChangeCount;
+    if (!changed && !keyframeRequested && !catchUpRequested) {
+        return nullptr;
+    }
+    if (now < lastFrameTime + FRAME_DURATION_MS) {
+        return nullptr;
+    }
+    // Periodic keyframes ride on frames that would be sent anyway; only a
+    // waiting viewer justifies one while the game is idle
+    bool intervalPassed = now >= lastKeyframeTime + KEYFRAME_INTERVAL_MS;
+    bool keyframe = keyframeRequested || (intervalPassed && (changed || catchUpRequested));
+    if (!changed && !keyframe) {
+        return nullptr;
+    }
+
+    if (keyframe) {
+        // Also resets the style; the viewer's terminal starts out (or was
+        // put back) in the default one
+        renderer.clearScreen();
+    }
+    switch (game.getState()) {
+        case GameState::MENU:
+            renderer.renderMenu();
+            break;
+        case GameState::PLAYING:
+            renderer.render(game);
+            break;
+        case GameState::PAUSED:
+            renderer.renderPaused(game);
+            break;
+        case GameState::GAME_OVER:
+            renderer.renderGameOver(game);
+            break;
+    }
+    lastChangeCount = changeCount;
+    lastFrameTime = now;
+    if (keyframe) {
+        lastKeyframeTime = now;
+        keyframeRequested = false;
+        catchUpRequested = false;
+        ++keyframeCount;
+    }
+    if (outbox.empty()) {
+        return nullptr;
+    }
+
+    auto frame = std::make_shared<BroadcastFrame>();
+    frame->bytes.assign(outbox.begin(), outbox.end());
+    frame->keyframe = keyframe;
+    frame->sequence = ++frameCount;
+    outbox.clear();
+    return frame;
+}
+
+uint64_t Broadcaster::getNextDeadline(uint64_t changeCount) const {
+    if (changeCount != lastChangeCount || keyframeRequested) {
+        return lastFrameTime + FRAME_DURATION_MS;
+    }
+    if (catchUpRequested) {
+        return std::max<uint64_t>(lastFrameTime + FRAME_DURATION_MS, lastKeyframeTime + KEYFRAME_INTERVAL_MS);
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+uint64_t Broadcaster::getFrameCount() const {
+    return frameCount;
+}
+
+uint64_t Broadcaster::getKeyframeCount() const {
+    return keyframeCount;
+}
+
+size_t Broadcaster::getMemoryBytes() const {
+    return sizeof(Broadcaster) + renderer.getMemoryBytes() + outbox.capacity();
+}
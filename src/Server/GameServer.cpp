@@ -0,0 +1,690 @@
+#include "../../include/Server/GameServer.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// epoll data for the descriptors that are not connections; connections
+// use their slot index
+const uint64_t LISTEN_TAG = std::numeric_limits<uint64_t>::max();
+const uint64_t SPECTATE_TAG = LISTEN_TAG - 1;
+const uint64_t WAKE_TAG = LISTEN_TAG - 2;
+const size_t REPORT_TAG = std::numeric_limits<size_t>::max();
+
+const int MAX_EVENTS = 256;
+const int LISTEN_BACKLOG = 1024;
+
+const char NO_GAMES_MESSAGE[] =
+    "No games in progress. The first one to start will appear here.\r\n\r\n"
+    "Left/Right: switch game   Q: quit\r\n";
+
+std::string describeErrno(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+std::string describeListener(int fd, const std::string& unixPath, const std::string& host, int port) {
+    if (!unixPath.empty()) {
+        return unixPath;
+    }
+    // Report the port actually bound, which differs when 0 was asked for
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (fd >= 0 && ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+        port = ntohs(address.sin_port);
+    }
+    return host + ":" + std::to_string(port);
+}
+
+}
+
+GameServer::GameServer(const ServerConfig& config)
+    : config(config)
+    , listenFd(-1)
+    , spectateFd(-1)
+    , epollFd(-1)
+    , wakeFd(-1)
+    , stopping(false)
+    , epoch(Clock::now())
+    , wheel(0) {
+    reportTimer.tag = REPORT_TAG;
+}
+
+GameServer::~GameServer() {
+    shutdown();
+    if (wakeFd >= 0) {
+        ::close(wakeFd);
+    }
+    if (epollFd >= 0) {
+        ::close(epollFd);
+    }
+}
+
+uint64_t GameServer::now() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - epoch).count());
+}
+
+bool GameServer::listen(std::string& error) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        error = describeErrno("epoll_create1");
+        return false;
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        error = describeErrno("eventfd");
+        return false;
+    }
+
+    listenFd = openListener(config.unixPath, config.port, error);
+    if (listenFd < 0) {
+        return false;
+    }
+    if (!config.spectateUnixPath.empty() || config.spectatePort >= 0) {
+        spectateFd = openListener(config.spectateUnixPath, config.spectatePort, error);
+        if (spectateFd < 0) {
+            return false;
+        }
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_TAG;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0) {
+        error = describeErrno("epoll_ctl");
+        return false;
+    }
+    if (spectateFd >= 0) {
+        event.data.u64 = SPECTATE_TAG;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, spectateFd, &event) != 0) {
+            error = describeErrno("epoll_ctl");
+            return false;
+        }
+    }
+    event.data.u64 = WAKE_TAG;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0) {
+        error = describeErrno("epoll_ctl");
+        return false;
+    }
+    return true;
+}
+
+int GameServer::openListener(const std::string& unixPath, int port, std::string& error) {
+    int fd;
+    if (!unixPath.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (unixPath.size() >= sizeof(address.sun_path)) {
+            error = "socket path too long: " + unixPath;
+            return -1;
+        }
+        std::memcpy(address.sun_path, unixPath.c_str(), unixPath.size() + 1);
+        // A socket left by an earlier run would make bind fail; anything
+        // else at that path is not ours to remove
+        struct stat info;
+        if (::stat(unixPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            ::unlink(unixPath.c_str());
+        }
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = describeErrno("socket");
+            return -1;
+        }
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            error = describeErrno("cannot bind " + unixPath);
+            ::close(fd);
+            return -1;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        if (::inet_pton(AF_INET, config.host.c_str(), &address.sin_addr) != 1) {
+            error = "not an IPv4 address: " + config.host;
+            return -1;
+        }
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = describeErrno("socket");
+            return -1;
+        }
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            error = describeErrno("cannot bind " + config.host + ":" + std::to_string(port));
+            ::close(fd);
+            return -1;
+        }
+    }
+    if (::listen(fd, LISTEN_BACKLOG) != 0) {
+        error = describeErrno("listen");
+        ::close(fd);
+        if (!unixPath.empty()) {
+            ::unlink(unixPath.c_str());
+        }
+        return -1;
+    }
+    return fd;
+}
+
+std::string GameServer::getAddress() const {
+    return describeListener(listenFd, config.unixPath, config.host, config.port);
+}
+
+std::string GameServer::getSpectateAddress() const {
+    if (spectateFd < 0) {
+        return std::string();
+    }
+    return describeListener(spectateFd, config.spectateUnixPath, config.host, config.spectatePort);
+}
+
+bool GameServer::run(std::string& error, int reportMillis, const ReportFn& report) {
+    if (listenFd < 0) {
+        error = "not listening";
+        return false;
+    }
+    if (reportMillis > 0 && report) {
+        wheel.schedule(reportTimer, now() + static_cast<uint64_t>(reportMillis));
+    }
+
+    epoll_event events[MAX_EVENTS];
+    bool ok = true;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, wheel.getTimeout(now()));
+        auto busyStart = Clock::now();
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = describeErrno("epoll_wait");
+            ok = false;
+            break;
+        }
+        ++stats.wakeups;
+
+        uint64_t time = now();
+        for (int i = 0; i < count; ++i) {
+            uint64_t tag = events[i].data.u64;
+            uint32_t flags = events[i].events;
+            if (tag == LISTEN_TAG) {
+                acceptAll(listenFd, false);
+            } else if (tag == SPECTATE_TAG) {
+                acceptAll(spectateFd, true);
+            } else if (tag == WAKE_TAG) {
+                uint64_t value;
+                while (::read(wakeFd, &value, sizeof(value)) > 0) {
+                }
+            } else {
+                // A slot closed earlier in this batch is not reused until
+                // reapClosed(), so stale events are recognisable
+                size_t index = static_cast<size_t>(tag);
+                if (slots[index].closing) {
+                    continue;
+                }
+                if (flags & EPOLLERR) {
+                    close(index);
+                    continue;
+                }
+                if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                    handleReadable(index);
+                }
+                if ((flags & EPOLLOUT) && !slots[index].closing) {
+                    service(index, time);
+                }
+            }
+        }
+
+        wheel.advance(now(), [&](TimerWheel::Timer& timer) {
+            if (timer.tag == REPORT_TAG) {
+                report(*this);
+                wheel.schedule(reportTimer, now() + static_cast<uint64_t>(reportMillis));
+                return;
+            }
+            ++stats.timersFired;
+            if (!slots[timer.tag].closing) {
+                service(timer.tag, now());
+            }
+        });
+        reapClosed();
+
+        stats.busyNanos += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - busyStart).count());
+    }
+    shutdown();
+    return ok;
+}
+
+void GameServer::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void GameServer::acceptAll(int listener, bool spectators) {
+    for (;;) {
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN once the backlog is empty; on anything else (out of
+            // descriptors, say) try again on the next wakeup
+            return;
+        }
+        bool full = spectators ? stats.spectators >= config.maxSpectators
+                               : stats.sessions >= config.maxSessions;
+        if (full) {
+            ::close(fd);
+            if (spectators) {
+                ++stats.spectatorsRejected;
+            } else {
+                ++stats.rejected;
+            }
+            continue;
+        }
+        if ((spectators ? config.spectateUnixPath : config.unixPath).empty()) {
+            // Frames are written whole, so waiting to coalesce only adds lag
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        size_t index = allocateSlot(fd);
+        if (index == NO_SLOT) {
+            continue;
+        }
+
+        uint64_t time = now();
+        Slot& slot = slots[index];
+        if (spectators) {
+            ++stats.spectatorsAccepted;
+            slot.viewer.reset(new Viewer(config.session.telnet));
+            ++stats.spectators;
+            stats.peakSpectators = std::max(stats.peakSpectators, stats.spectators);
+            size_t player = findPlayer(NO_SLOT, true);
+            if (player != NO_SLOT) {
+                attachViewer(index, player, time);
+            } else {
+                slot.viewer->showMessage(NO_GAMES_MESSAGE);
+                idleViewers.push_back(index);
+            }
+            flush(index);
+        } else {
+            ++stats.accepted;
+            slot.session.reset(new Session(config.session, time));
+            slot.session->timer.tag = index;
+            ++stats.sessions;
+            stats.peakSessions = std::max(stats.peakSessions, stats.sessions);
+            // Sends the menu
+            service(index, time);
+            // Spectators with nothing to watch get this game
+            std::vector<size_t> waiting;
+            waiting.swap(idleViewers);
+            for (size_t viewer : waiting) {
+                if (!slots[viewer].closing) {
+                    attachViewer(viewer, index, time);
+                }
+            }
+        }
+    }
+}
+
+size_t GameServer::allocateSlot(int fd) {
+    size_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = slots.size();
+        slots.emplace_back();
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u64 = index;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        ::close(fd);
+        freeSlots.push_back(index);
+        return NO_SLOT;
+    }
+    slots[index].fd = fd;
+    return index;
+}
+
+void GameServer::handleReadable(size_t index) {
+    Slot& slot = slots[index];
+    unsigned char buffer[READ_BUFFER_SIZE];
+    // One read per wakeup keeps a chatty client from starving the rest;
+    // epoll is level-triggered, so anything left is reported again
+    ssize_t count = ::read(slot.fd, buffer, sizeof(buffer));
+    if (count == 0) {
+        close(index);
+        return;
+    }
+    if (count < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close(index);
+        }
+        return;
+    }
+
+    stats.bytesIn += static_cast<uint64_t>(count);
+    uint64_t time = now();
+    if (slot.viewer) {
+        ViewerRequest request = slot.viewer->receive(buffer, static_cast<size_t>(count));
+        if (request == ViewerRequest::QUIT) {
+            slot.viewer->sayGoodbye();
+            flush(index);
+            close(index);
+        } else if (request != ViewerRequest::NONE) {
+            size_t from = slot.watching;
+            size_t next = findPlayer(from, request == ViewerRequest::NEXT_GAME);
+            if (next != NO_SLOT && next != from) {
+                detachViewer(index);
+                attachViewer(index, next, time);
+            }
+        }
+        return;
+    }
+
+    bool playing = slot.session->receive(buffer, static_cast<size_t>(count), time, Clock::now());
+    service(index, time);
+    if (!playing && !slots[index].closing) {
+        // The farewell has had its one chance to go out
+        close(index);
+    }
+}
+
+void GameServer::service(size_t index, uint64_t time) {
+    Slot& slot = slots[index];
+    flush(index);
+    if (slot.closing || slot.viewer) {
+        return;
+    }
+    Session& session = *slot.session;
+    session.tick(time);
+    flush(index);
+    if (slot.closing) {
+        return;
+    }
+    if (session.getOutputSize() > MAX_PENDING_OUTPUT) {
+        close(index);
+        return;
+    }
+
+    uint64_t deadline = session.getNextDeadline();
+    if (slot.broadcaster) {
+        deadline = std::min(deadline, broadcast(index, time));
+    }
+    if (deadline == std::numeric_limits<uint64_t>::max()) {
+        wheel.cancel(session.timer);
+    } else {
+        wheel.schedule(session.timer, deadline);
+    }
+}
+
+uint64_t GameServer::broadcast(size_t index, uint64_t time) {
+    Slot& player = slots[index];
+    Session& session = *player.session;
+    Broadcaster& broadcaster = *player.broadcaster;
+
+    BroadcastFramePtr frame = broadcaster.poll(session.getGame(), session.getChangeCount(), time);
+    if (frame) {
+        ++stats.broadcastFrames;
+        if (frame->keyframe) {
+            ++stats.keyframes;
+        }
+        // Closing a viewer leaves this list alone until reapClosed()
+        for (size_t viewerIndex : player.viewers) {
+            if (slots[viewerIndex].closing) {
+                continue;
+            }
+            Viewer& viewer = *slots[viewerIndex].viewer;
+            uint64_t droppedBefore = viewer.getDroppedFrames();
+            viewer.push(frame);
+            stats.framesDropped += viewer.getDroppedFrames() - droppedBefore;
+            if (viewer.isWaitingForKeyframe()) {
+                broadcaster.requestCatchUp();
+            } else {
+                ++stats.framesQueued;
+            }
+            flush(viewerIndex);
+        }
+    }
+    return broadcaster.getNextDeadline(session.getChangeCount());
+}
+
+void GameServer::attachViewer(size_t viewer, size_t player, uint64_t time) {
+    Slot& viewerSlot = slots[viewer];
+    Slot& playerSlot = slots[player];
+    viewerSlot.viewer->switchGame();
+    viewerSlot.watching = player;
+    playerSlot.viewers.push_back(viewer);
+    if (!playerSlot.broadcaster) {
+        playerSlot.broadcaster.reset(new Broadcaster(Board::WIDTH, Board::HEIGHT, time));
+    }
+    playerSlot.broadcaster->requestKeyframe();
+    // Encodes the keyframe now rather than at the game's next change
+    service(player, time);
+}
+
+void GameServer::detachViewer(size_t viewer) {
+    Slot& viewerSlot = slots[viewer];
+    if (viewerSlot.watching == NO_SLOT) {
+        auto it = std::find(idleViewers.begin(), idleViewers.end(), viewer);
+        if (it != idleViewers.end()) {
+            idleViewers.erase(it);
+        }
+        return;
+    }
+    Slot& playerSlot = slots[viewerSlot.watching];
+    auto it = std::find(playerSlot.viewers.begin(), playerSlot.viewers.end(), viewer);
+    if (it != playerSlot.viewers.end()) {
+        *it = playerSlot.viewers.back();
+        playerSlot.viewers.pop_back();
+    }
+    // Nobody left to encode for
+    if (playerSlot.viewers.empty()) {
+        playerSlot.broadcaster.reset();
+    }
+    viewerSlot.watching = NO_SLOT;
+}
+
+size_t GameServer::findPlayer(size_t from, bool forwards) const {
+    size_t count = slots.size();
+    if (count == 0) {
+        return NO_SLOT;
+    }
+    if (from == NO_SLOT) {
+        from = forwards ? count - 1 : 0;
+    }
+    for (size_t step = 1; step <= count; ++step) {
+        size_t index = forwards ? (from + step) % count : (from + count - step) % count;
+        if (slots[index].session && !slots[index].closing) {
+            return index;
+        }
+    }
+    return NO_SLOT;
+}
+
+void GameServer::rehomeViewer(size_t viewer, size_t from, uint64_t time) {
+    slots[viewer].watching = NO_SLOT;
+    size_t next = findPlayer(from, true);
+    if (next != NO_SLOT) {
+        attachViewer(viewer, next, time);
+        return;
+    }
+    slots[viewer].viewer->showMessage(NO_GAMES_MESSAGE);
+    idleViewers.push_back(viewer);
+    flush(viewer);
+}
+
+void GameServer::flush(size_t index) {
+    Slot& slot = slots[index];
+    bool pending = false;
+    for (;;) {
+        const char* data = slot.viewer ? slot.viewer->getOutput() : slot.session->getOutput();
+        size_t size = slot.viewer ? slot.viewer->getOutputSize() : slot.session->getOutputSize();
+        if (size == 0) {
+            break;
+        }
+        ssize_t sent = ::send(slot.fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pending = true;
+                break;
+            }
+            close(index);
+            return;
+        }
+        stats.bytesOut += static_cast<uint64_t>(sent);
+        if (slot.viewer) {
+            slot.viewer->consumeOutput(static_cast<size_t>(sent));
+            continue;
+        }
+        uint64_t latency;
+        if (slot.session->consumeOutput(static_cast<size_t>(sent), Clock::now(), latency)) {
+            stats.keyLatencyNanos.record(latency);
+        }
+    }
+    // A spectator that has stopped reading is dropped, as a session is past
+    // MAX_PENDING_OUTPUT
+    if (slot.viewer && slot.viewer->isStalled()) {
+        close(index);
+        return;
+    }
+    // Only ask for writability while something is waiting, or every idle
+    // connection would wake the loop
+    watchWrites(index, pending);
+}
+
+void GameServer::watchWrites(size_t index, bool enabled) {
+    Slot& slot = slots[index];
+    if (slot.watchingWrites == enabled) {
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (enabled) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u64 = index;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, slot.fd, &event) != 0) {
+        close(index);
+        return;
+    }
+    slot.watchingWrites = enabled;
+}
+
+void GameServer::close(size_t index) {
+    Slot& slot = slots[index];
+    if (slot.closing) {
+        return;
+    }
+    slot.closing = true;
+    if (slot.session) {
+        wheel.cancel(slot.session->timer);
+        --stats.sessions;
+    } else {
+        --stats.spectators;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, slot.fd, nullptr);
+    ::close(slot.fd);
+    slot.fd = -1;
+    closingSlots.push_back(index);
+    ++stats.closed;
+}
+
+void GameServer::reapClosed() {
+    uint64_t time = now();
+    // Sending a spectator elsewhere can close more connections, which are
+    // reaped on the next pass
+    while (!closingSlots.empty()) {
+        std::vector<size_t> closed;
+        closed.swap(closingSlots);
+
+        // Viewers first, so the games they watched have accurate lists
+        for (size_t index : closed) {
+            if (slots[index].viewer) {
+                detachViewer(index);
+            }
+        }
+        for (size_t index : closed) {
+            if (!slots[index].session) {
+                continue;
+            }
+            std::vector<size_t> viewers = slots[index].viewers;
+            for (size_t viewer : viewers) {
+                if (!slots[viewer].closing) {
+                    rehomeViewer(viewer, index, time);
+                }
+            }
+        }
+        for (size_t index : closed) {
+            slots[index] = Slot();
+            freeSlots.push_back(index);
+        }
+    }
+}
+
+void GameServer::shutdown() {
+    for (size_t index = 0; index < slots.size(); ++index) {
+        if ((slots[index].session || slots[index].viewer) && !slots[index].closing) {
+            close(index);
+        }
+    }
+    reapClosed();
+    wheel.cancel(reportTimer);
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        if (!config.unixPath.empty()) {
+            ::unlink(config.unixPath.c_str());
+        }
+    }
+    if (spectateFd >= 0) {
+        ::close(spectateFd);
+        spectateFd = -1;
+        if (!config.spectateUnixPath.empty()) {
+            ::unlink(config.spectateUnixPath.c_str());
+        }
+    }
+}
+
+const ServerStats& GameServer::getStats() const {
+    return stats;
+}
+
+size_t GameServer::getSessionMemoryBytes() const {
+    size_t total = 0;
+    for (const Slot& slot : slots) {
+        if (slot.session && !slot.closing) {
+            total += slot.session->getMemoryBytes() + slot.viewers.capacity() * sizeof(size_t);
+            if (slot.broadcaster) {
+                total += slot.broadcaster->getMemoryBytes();
+            }
+        }
+    }
+    return total;
+}
+
+size_t GameServer::getSpectatorMemoryBytes() const {
+    size_t total = 0;
+    for (const Slot& slot : slots) {
+        if (slot.viewer && !slot.closing) {
+            total += slot.viewer->getMemoryBytes();
+        }
+    }
+    return total;
+}
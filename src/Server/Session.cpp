@@ -0,0 +1,210 @@
+#include "../../include/Server/Session.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const size_t KEY_BUFFER_SIZE = 256;
+
+}
+
+Session::Session(const SessionConfig& config, uint64_t now)
+    : renderer(Board::WIDTH, Board::HEIGHT, -1)
+    , outboxSent(0)
+    , lastTickTime(now)
+    , lastRenderTime(now)
+    , needsRender(false)
+    , changes(0)
+    , quit(false)
+    , keyWaiting(false)
+    , frameAnswersKey(false) {
+    game.setPiecePolicy(config.piecePolicy);
+    game.setPreviewDepth(config.previewDepth);
+
+    if (config.telnet) {
+        outbox.insert(outbox.end(), TelnetFilter::CHARACTER_MODE,
+                      TelnetFilter::CHARACTER_MODE + sizeof(TelnetFilter::CHARACTER_MODE));
+    }
+    renderer.setOutbox(&outbox);
+    renderer.hideCursor();
+    renderer.clearScreen();
+    renderer.renderMenu();
+}
+
+bool Session::receive(const unsigned char* data, size_t size, uint64_t now, Clock::time_point readTime) {
+    // Telnet commands can split across reads like escape sequences, so the
+    // filter keeps its state between calls and works a chunk at a time
+    unsigned char keys[KEY_BUFFER_SIZE];
+    while (size > 0 && !quit) {
+        size_t chunk = std::min(size, KEY_BUFFER_SIZE);
+        std::copy(data, data + chunk, keys);
+        data += chunk;
+        size -= chunk;
+
+        size_t keyCount = telnet.filter(keys, chunk);
+        if (keyCount == 0) {
+            continue;
+        }
+        if (!keyWaiting) {
+            keyWaiting = true;
+            keyTime = readTime;
+        }
+        decoder.feed(keys, keyCount, [&](InputAction action) {
+            if (!quit) {
+                handleAction(action, now);
+            }
+        });
+    }
+    if (quit) {
+        renderer.showCursor();
+        renderer.clearScreen();
+        return false;
+    }
+    return true;
+}
+
+void Session::handleAction(InputAction action, uint64_t now) {
+    // Bring gravity up to date first so the key lands where the player saw
+    // the piece
+    update(now);
+    needsRender = true;
+    ++changes;
+
+    if (action == InputAction::QUIT) {
+        quit = true;
+        return;
+    }
+    switch (game.getState()) {
+        case GameState::MENU:
+            if (action == InputAction::START) {
+                game.applyAction(action);
+                renderer.clearScreen();
+                lastTickTime = now;
+            }
+            break;
+        case GameState::PLAYING:
+            // The stats overlay belongs to the local front end
+            if (action != InputAction::TOGGLE_STATS) {
+                game.applyAction(action);
+            }
+            break;
+        case GameState::PAUSED:
+            if (action == InputAction::PAUSE) {
+                game.applyAction(action);
+                renderer.clearScreen();
+                lastTickTime = now;
+            }
+            break;
+        case GameState::GAME_OVER:
+            if (action == InputAction::RESTART) {
+                game.applyAction(action);
+                renderer.clearScreen();
+                lastTickTime = now;
+            }
+            break;
+    }
+}
+
+void Session::update(uint64_t now) {
+    if (game.getState() != GameState::PLAYING || now <= lastTickTime) {
+        return;
+    }
+    uint64_t elapsed = now - lastTickTime;
+    // Only a gravity step changes what is on screen
+    if (elapsed >= static_cast<uint64_t>(game.getTicksUntilDrop())) {
+        needsRender = true;
+        ++changes;
+    }
+    game.advance(static_cast<int>(std::min<uint64_t>(elapsed, std::numeric_limits<int>::max())));
+    lastTickTime = now;
+}
+
+void Session::tick(uint64_t now) {
+    // Nothing more is drawn after the farewell
+    if (quit) {
+        return;
+    }
+    update(now);
+    if (needsRender && outboxSent == outbox.size() && now - lastRenderTime >= FRAME_DURATION_MS) {
+        render();
+        lastRenderTime = now;
+        needsRender = false;
+    }
+}
+
+uint64_t Session::getNextDeadline() const {
+    uint64_t deadline = std::numeric_limits<uint64_t>::max();
+    if (game.getState() == GameState::PLAYING) {
+        deadline = lastTickTime + static_cast<uint64_t>(game.getTicksUntilDrop());
+    }
+    // A frame waiting on the outbox is rescheduled once it drains
+    if (needsRender && outboxSent == outbox.size()) {
+        deadline = std::min(deadline, lastRenderTime + FRAME_DURATION_MS);
+    }
+    return deadline;
+}
+
+void Session::render() {
+    switch (game.getState()) {
+        case GameState::MENU:
+            // Menu is rendered once when entering, no need to re-render
+            break;
+        case GameState::PLAYING:
+            renderer.render(game);
+            break;
+        case GameState::PAUSED:
+            renderer.renderPaused(game);
+            break;
+        case GameState::GAME_OVER:
+            renderer.renderGameOver(game);
+            break;
+    }
+    if (keyWaiting) {
+        keyWaiting = false;
+        // A key that changed nothing on screen has no frame to time
+        if (outbox.empty()) {
+            return;
+        }
+        if (!frameAnswersKey || keyTime < frameKeyTime) {
+            frameKeyTime = keyTime;
+        }
+        frameAnswersKey = true;
+    }
+}
+
+const char* Session::getOutput() const {
+    return outbox.data() + outboxSent;
+}
+
+size_t Session::getOutputSize() const {
+    return outbox.size() - outboxSent;
+}
+
+bool Session::consumeOutput(size_t count, Clock::time_point sentTime, uint64_t& latencyNanos) {
+    outboxSent += count;
+    if (outboxSent < outbox.size()) {
+        return false;
+    }
+    // Drained: start over at the front, keeping the capacity for next frame
+    outbox.clear();
+    outboxSent = 0;
+    if (!frameAnswersKey) {
+        return false;
+    }
+    frameAnswersKey = false;
+    latencyNanos = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sentTime - frameKeyTime).count());
+    return true;
+}
+
+size_t Session::getMemoryBytes() const {
+    return sizeof(Session) + renderer.getMemoryBytes() + outbox.capacity();
+}
+
+const Game& Session::getGame() const {
+    return game;
+}
+
+uint64_t Session::getChangeCount() const {
+    return changes;
+}
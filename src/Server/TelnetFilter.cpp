@@ -0,0 +1,55 @@
+#include "../../include/Server/TelnetFilter.h"
+
+namespace {
+
+const unsigned char IAC = 255;
+const unsigned char SB = 250;
+const unsigned char SE = 240;
+const unsigned char WILL = 251;
+const unsigned char DONT = 254;
+
+}
+
+const char TelnetFilter::CHARACTER_MODE[6] = {'\xff', '\xfb', '\x01', '\xff', '\xfb', '\x03'};
+
+size_t TelnetFilter::filter(unsigned char* data, size_t size) {
+    size_t kept = 0;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char ch = data[i];
+        switch (state) {
+            case State::DATA:
+                if (ch == IAC) {
+                    state = State::COMMAND;
+                } else {
+                    data[kept++] = ch;
+                }
+                break;
+            case State::COMMAND:
+                if (ch == IAC) {
+                    // Escaped 255 is a data byte, though not a key we use
+                    state = State::DATA;
+                } else if (ch == SB) {
+                    state = State::SUBNEGOTIATION;
+                } else if (ch >= WILL && ch <= DONT) {
+                    state = State::OPTION;
+                } else {
+                    state = State::DATA;
+                }
+                break;
+            case State::OPTION:
+                // Option replies are accepted as they come; the game works
+                // either way, only line-buffered input feels worse
+                state = State::DATA;
+                break;
+            case State::SUBNEGOTIATION:
+                if (ch == IAC) {
+                    state = State::SUBNEGOTIATION_COMMAND;
+                }
+                break;
+            case State::SUBNEGOTIATION_COMMAND:
+                state = ch == SE ? State::DATA : State::SUBNEGOTIATION;
+                break;
+        }
+    }
+    return kept;
+}
@@ -0,0 +1,63 @@
+#include "../../include/Server/TimerWheel.h"
+
+TimerWheel::TimerWheel(uint64_t now)
+    : current(now)
+    , armedCount(0) {
+    for (Timer& head : slots) {
+        head.prev = &head;
+        head.next = &head;
+    }
+}
+
+void TimerWheel::schedule(Timer& timer, uint64_t deadline) {
+    if (timer.armed) {
+        unlink(timer);
+    } else {
+        timer.armed = true;
+        ++armedCount;
+    }
+    // Overdue timers go in the next slot to be visited
+    timer.deadline = deadline > current ? deadline : current + 1;
+    link(timer);
+}
+
+void TimerWheel::cancel(Timer& timer) {
+    if (!timer.armed) {
+        return;
+    }
+    unlink(timer);
+    timer.armed = false;
+    --armedCount;
+}
+
+int TimerWheel::getTimeout(uint64_t now) const {
+    if (armedCount == 0) {
+        return -1;
+    }
+    for (uint64_t tick = current + 1; tick <= current + SLOTS; ++tick) {
+        const Timer& head = slots[tick & (SLOTS - 1)];
+        if (head.next != &head) {
+            return tick > now ? static_cast<int>(tick - now) : 0;
+        }
+    }
+    return SLOTS;
+}
+
+size_t TimerWheel::getArmedCount() const {
+    return armedCount;
+}
+
+void TimerWheel::link(Timer& timer) {
+    Timer& head = slots[timer.deadline & (SLOTS - 1)];
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+}
+
+void TimerWheel::unlink(Timer& timer) {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
@@ -0,0 +1,178 @@
+#include "../../include/Server/Viewer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const size_t KEY_BUFFER_SIZE = 256;
+
+BroadcastFramePtr makeFrame(const char* text) {
+    auto frame = std::make_shared<BroadcastFrame>();
+    frame->bytes.assign(text, text + std::strlen(text));
+    return frame;
+}
+
+// Control frames every viewer needs, built once and shared like the rest
+const BroadcastFramePtr& resetStyleFrame() {
+    static const BroadcastFramePtr frame = makeFrame("\033[0m");
+    return frame;
+}
+
+const BroadcastFramePtr& welcomeFrame() {
+    static const BroadcastFramePtr frame = makeFrame("\033[0m\033[?25l\033[2J\033[H");
+    return frame;
+}
+
+const BroadcastFramePtr& goodbyeFrame() {
+    static const BroadcastFramePtr frame = makeFrame("\033[0m\033[?25h\033[2J\033[H");
+    return frame;
+}
+
+}
+
+Viewer::Viewer(bool telnetClient)
+    : headSent(0)
+    , queuedBytes(0)
+    , waitingForKeyframe(true)
+    , overflowsWithoutProgress(0)
+    , droppedFrames(0) {
+    if (telnetClient) {
+        static const BroadcastFramePtr characterMode = [] {
+            auto frame = std::make_shared<BroadcastFrame>();
+            frame->bytes.assign(TelnetFilter::CHARACTER_MODE,
+                                TelnetFilter::CHARACTER_MODE + sizeof(TelnetFilter::CHARACTER_MODE));
+            return BroadcastFramePtr(frame);
+        }();
+        pushPrivate(characterMode);
+    }
+    pushPrivate(welcomeFrame());
+}
+
+ViewerRequest Viewer::receive(const unsigned char* data, size_t size) {
+    ViewerRequest request = ViewerRequest::NONE;
+    unsigned char keys[KEY_BUFFER_SIZE];
+    while (size > 0) {
+        size_t chunk = std::min(size, KEY_BUFFER_SIZE);
+        std::copy(data, data + chunk, keys);
+        data += chunk;
+        size -= chunk;
+
+        size_t keyCount = telnet.filter(keys, chunk);
+        decoder.feed(keys, keyCount, [&](InputAction action) {
+            if (request == ViewerRequest::QUIT) {
+                return;
+            }
+            switch (action) {
+                case InputAction::MOVE_LEFT:
+                    request = ViewerRequest::PREVIOUS_GAME;
+                    break;
+                case InputAction::MOVE_RIGHT:
+                    request = ViewerRequest::NEXT_GAME;
+                    break;
+                case InputAction::QUIT:
+                    request = ViewerRequest::QUIT;
+                    break;
+                default:
+                    break;
+            }
+        });
+    }
+    return request;
+}
+
+void Viewer::push(const BroadcastFramePtr& frame) {
+    if (frame->keyframe) {
+        // It redraws everything, so nothing queued ahead of it matters
+        if (queue.size() > (headSent > 0 ? 1u : 0u)) {
+            dropUnsent();
+        }
+        waitingForKeyframe = false;
+    } else if (waitingForKeyframe) {
+        ++droppedFrames;
+        return;
+    } else if (queuedBytes + frame->bytes.size() > MAX_QUEUED_BYTES) {
+        dropUnsent();
+        ++droppedFrames;
+        ++overflowsWithoutProgress;
+        waitingForKeyframe = true;
+        return;
+    }
+    queue.push_back(frame);
+    queuedBytes += frame->bytes.size();
+}
+
+void Viewer::switchGame() {
+    dropUnsent();
+    waitingForKeyframe = true;
+}
+
+void Viewer::showMessage(const char* text) {
+    switchGame();
+    pushPrivate(welcomeFrame());
+    pushPrivate(makeFrame(text));
+}
+
+void Viewer::sayGoodbye() {
+    dropUnsent();
+    pushPrivate(goodbyeFrame());
+}
+
+void Viewer::dropUnsent() {
+    // A frame already partly sent has to finish, or the terminal would be
+    // left inside an escape sequence. Control frames are kept: only
+    // broadcast frames are numbered, and only they are superseded.
+    size_t keep = headSent > 0 ? 1 : 0;
+    for (size_t i = queue.size(); i-- > keep;) {
+        if (queue[i]->sequence != 0) {
+            queuedBytes -= queue[i]->bytes.size();
+            queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(i));
+            ++droppedFrames;
+        }
+    }
+    // Control frames stay queued, so without this check a viewer that never
+    // reads would collect another reset with every overflow
+    if (queue.empty() || queue.back() != resetStyleFrame()) {
+        pushPrivate(resetStyleFrame());
+    }
+}
+
+void Viewer::pushPrivate(const BroadcastFramePtr& frame) {
+    queue.push_back(frame);
+    queuedBytes += frame->bytes.size();
+}
+
+bool Viewer::isWaitingForKeyframe() const {
+    return waitingForKeyframe;
+}
+
+bool Viewer::isStalled() const {
+    return overflowsWithoutProgress >= MAX_STALLED_OVERFLOWS || queuedBytes > MAX_QUEUED_BYTES;
+}
+
+const char* Viewer::getOutput() const {
+    return queue.empty() ? nullptr : queue.front()->bytes.data() + headSent;
+}
+
+size_t Viewer::getOutputSize() const {
+    return queue.empty() ? 0 : queue.front()->bytes.size() - headSent;
+}
+
+void Viewer::consumeOutput(size_t count) {
+    if (count > 0) {
+        overflowsWithoutProgress = 0;
+    }
+    queuedBytes -= count;
+    headSent += count;
+    while (!queue.empty() && headSent >= queue.front()->bytes.size()) {
+        headSent -= queue.front()->bytes.size();
+        queue.pop_front();
+    }
+}
+
+uint64_t Viewer::getDroppedFrames() const {
+    return droppedFrames;
+}
+
+size_t Viewer::getMemoryBytes() const {
+    return sizeof(Viewer) + queue.size() * sizeof(BroadcastFramePtr);
+}
@@ -0,0 +1,114 @@
+#include "../../include/Sim/BatchRunner.h"
+#include "../../include/Sim/WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void SimStats::addGame(const Game& game, uint64_t gameActions) {
+    int score = game.getScore();
+    if (games == 0 || score < minScore) minScore = score;
+    if (games == 0 || score > maxScore) maxScore = score;
+    maxLines = std::max(maxLines, game.getLinesCleared());
+    maxLevel = std::max(maxLevel, game.getLevel());
+
+    ++games;
+    pieces += static_cast<uint64_t>(game.getPiecesPlaced());
+    actions += gameActions;
+    lines += static_cast<uint64_t>(game.getLinesCleared());
+    scoreSum += static_cast<uint64_t>(score);
+    scoreSumSquares += static_cast<double>(score) * score;
+}
+
+void SimStats::merge(const SimStats& other) {
+    if (other.games == 0) return;
+    if (games == 0 || other.minScore < minScore) minScore = other.minScore;
+    if (games == 0 || other.maxScore > maxScore) maxScore = other.maxScore;
+    maxLines = std::max(maxLines, other.maxLines);
+    maxLevel = std::max(maxLevel, other.maxLevel);
+
+    games += other.games;
+    pieces += other.pieces;
+    actions += other.actions;
+    lines += other.lines;
+    scoreSum += other.scoreSum;
+    scoreSumSquares += other.scoreSumSquares;
+}
+
+double SimStats::getMeanScore() const {
+    return games > 0 ? static_cast<double>(scoreSum) / games : 0.0;
+}
+
+double SimStats::getScoreStdDev() const {
+    if (games < 2) return 0.0;
+    double mean = getMeanScore();
+    double variance = scoreSumSquares / games - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+BatchRunner::BatchRunner(const SimConfig& config, const Policy& prototype)
+    : config(config)
+    , prototype(prototype) {
+}
+
+uint64_t BatchRunner::gameSeed(uint64_t baseSeed, uint64_t gameIndex) {
+    uint64_t state = baseSeed ^ (gameIndex * 0xD1B54A32D192ED03ULL);
+    return Random::splitMix64(state);
+}
+
+namespace {
+// Everything one worker touches while playing, padded so neighbouring
+// workers never share a cache line
+struct alignas(64) WorkerContext {
+    Game game{0};
+    std::unique_ptr<Policy> policy;
+    SimStats stats;
+};
+}
+
+SimStats BatchRunner::run() {
+    WorkStealingPool pool(config.threads);
+    const unsigned threadCount = pool.getThreadCount();
+
+    std::vector<WorkerContext> contexts(threadCount);
+    for (auto& context : contexts) {
+        context.policy = prototype.clone();
+        context.game.setPiecePolicy(config.piecePolicy);
+    }
+
+    // Enough chunks for stealing to even out long games, few enough that
+    // scheduling overhead stays invisible
+    const uint64_t chunkSize = std::max<uint64_t>(1, std::min<uint64_t>(256, config.games / (threadCount * 16ULL)));
+    const SimConfig settings = config;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t first = 0; first < settings.games; first += chunkSize) {
+        uint64_t last = std::min(settings.games, first + chunkSize);
+        pool.submit([&contexts, settings, first, last](unsigned worker) {
+            WorkerContext& context = contexts[worker];
+            for (uint64_t index = first; index < last; ++index) {
+                uint64_t seed = gameSeed(settings.seed, index);
+                context.game.setSeed(seed);
+                context.game.start();
+                context.policy->reset(seed ^ 0x5DEECE66DULL);
+
+                uint64_t actions = 0;
+                while (context.game.getState() == GameState::PLAYING &&
+                       context.game.getPiecesPlaced() < settings.maxPieces) {
+                    context.game.step(context.policy->chooseAction(context.game), settings.ticksPerAction);
+                    ++actions;
+                }
+                context.stats.addGame(context.game, actions);
+            }
+        });
+    }
+    pool.wait();
+
+    SimStats total;
+    for (const auto& context : contexts) {
+        total.merge(context.stats);
+    }
+    total.threads = threadCount;
+    total.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
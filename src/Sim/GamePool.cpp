@@ -0,0 +1,406 @@
+#include "../../include/Sim/GamePool.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// Gravity intervals by level; from MAX_INTERVAL_LEVEL on they stop
+// shrinking
+const int MAX_INTERVAL_LEVEL = 11;
+
+const std::array<int, MAX_INTERVAL_LEVEL + 1>& dropIntervals() {
+    static const std::array<int, MAX_INTERVAL_LEVEL + 1> intervals = [] {
+        std::array<int, MAX_INTERVAL_LEVEL + 1> table{};
+        for (int level = 1; level <= MAX_INTERVAL_LEVEL; ++level) {
+            table[level] = Game::getDropIntervalTicks(level);
+        }
+        return table;
+    }();
+    return intervals;
+}
+
+}
+
+GamePool::GamePool(size_t size) {
+    resize(size);
+}
+
+size_t GamePool::size() const {
+    return states.size();
+}
+
+void GamePool::resize(size_t size) {
+    const size_t oldSize = states.size();
+    boards.resize(size);
+    current.resize(size, PieceState{Tetromino(), 0, 0});
+    states.resize(size);
+    gravityTicks.resize(size);
+    scores.resize(size);
+    levels.resize(size);
+    lines.resize(size);
+    piecesPlaced.resize(size);
+    tickCounts.resize(size);
+    rngs.resize(size);
+    queues.resize(size);
+    queueCounts.resize(size);
+    policies.resize(size);
+    for (size_t game = oldSize; game < size; ++game) {
+        seed(game, 0, PiecePolicy::UNIFORM);
+    }
+}
+
+void GamePool::seed(size_t game, uint64_t seedValue, PiecePolicy policy) {
+    Rows& rows = boards[game];
+    for (int y = 0; y < static_cast<int>(rows.words.size()); ++y) {
+        rows.words[y] = y < PAD_ROWS + HEIGHT ? WALL_ROW : SOLID_ROW;
+    }
+    current[game] = PieceState{Tetromino(), 0, 0};
+    states[game] = static_cast<uint8_t>(GameState::MENU);
+    gravityTicks[game] = 0;
+    scores[game] = 0;
+    levels[game] = 1;
+    lines[game] = 0;
+    piecesPlaced[game] = 0;
+    tickCounts[game] = 0;
+    rngs[game].seed(seedValue);
+    queues[game] = 0;
+    queueCounts[game] = 0;
+    policies[game] = static_cast<uint8_t>(policy);
+    refillQueue(game);
+}
+
+bool GamePool::applyAction(size_t game, InputAction action) {
+    switch (static_cast<GameState>(states[game])) {
+        case GameState::MENU:
+        case GameState::GAME_OVER:
+            if (action == InputAction::START || action == InputAction::RESTART) {
+                start(game);
+                return true;
+            }
+            return false;
+        case GameState::PAUSED:
+            if (action == InputAction::PAUSE) {
+                states[game] = static_cast<uint8_t>(GameState::PLAYING);
+                return true;
+            }
+            return false;
+        case GameState::PLAYING:
+            break;
+    }
+
+    switch (action) {
+        case InputAction::MOVE_LEFT:
+            return move(game, -1, 0);
+        case InputAction::MOVE_RIGHT:
+            return move(game, 1, 0);
+        case InputAction::MOVE_DOWN:
+            // A successful soft drop restarts the gravity interval
+            if (move(game, 0, 1)) {
+                gravityTicks[game] = 0;
+                return true;
+            }
+            return false;
+        case InputAction::HARD_DROP: {
+            PieceState& state = current[game];
+            int landingY = state.y;
+            while (canPlace(game, state.piece, state.x, landingY + 1)) {
+                ++landingY;
+            }
+            scores[game] += 2 * (landingY - state.y);
+            state.y = static_cast<int8_t>(landingY);
+            lock(game);
+            gravityTicks[game] = 0;
+            return true;
+        }
+        case InputAction::ROTATE_CW:
+            rotate(game, true);
+            return true;
+        case InputAction::ROTATE_CCW:
+            rotate(game, false);
+            return true;
+        case InputAction::PAUSE:
+            states[game] = static_cast<uint8_t>(GameState::PAUSED);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void GamePool::advance(size_t game, int ticks) {
+    if (states[game] != static_cast<uint8_t>(GameState::PLAYING) || ticks <= 0) return;
+
+    tickCounts[game] += ticks;
+    int pending = gravityTicks[game] + ticks;
+
+    int interval = getDropIntervalTicks(levels[game]);
+    while (pending >= interval) {
+        pending -= interval;
+        if (!move(game, 0, 1)) {
+            lock(game);
+            if (states[game] != static_cast<uint8_t>(GameState::PLAYING)) {
+                break;
+            }
+        }
+        interval = getDropIntervalTicks(levels[game]);
+    }
+    gravityTicks[game] = pending;
+}
+
+void GamePool::step(size_t game, InputAction action, int ticks) {
+    applyAction(game, action);
+    advance(game, ticks);
+}
+
+void GamePool::applyActions(const InputAction* actions) {
+    const size_t count = size();
+    for (size_t game = 0; game < count; ++game) {
+        applyAction(game, actions[game]);
+    }
+}
+
+void GamePool::advanceAll(int ticks) {
+    const size_t count = size();
+    for (size_t game = 0; game < count; ++game) {
+        advance(game, ticks);
+    }
+}
+
+void GamePool::stepAll(const InputAction* actions, int ticks) {
+    const size_t count = size();
+    for (size_t game = 0; game < count; ++game) {
+        applyAction(game, actions[game]);
+        advance(game, ticks);
+    }
+}
+
+size_t GamePool::restartFinished() {
+    const size_t count = size();
+    size_t restarted = 0;
+    for (size_t game = 0; game < count; ++game) {
+        if (states[game] == static_cast<uint8_t>(GameState::GAME_OVER)) {
+            start(game);
+            ++restarted;
+        }
+    }
+    return restarted;
+}
+
+GameState GamePool::getState(size_t game) const {
+    return static_cast<GameState>(states[game]);
+}
+
+int GamePool::getScore(size_t game) const {
+    return scores[game];
+}
+
+int GamePool::getLevel(size_t game) const {
+    return levels[game];
+}
+
+int GamePool::getLinesCleared(size_t game) const {
+    return lines[game];
+}
+
+long long GamePool::getPiecesPlaced(size_t game) const {
+    return piecesPlaced[game];
+}
+
+long long GamePool::getTickCount(size_t game) const {
+    return tickCounts[game];
+}
+
+Tetromino GamePool::getCurrentTetromino(size_t game) const {
+    return current[game].piece;
+}
+
+Tetromino GamePool::getNextTetromino(size_t game) const {
+    return Tetromino(static_cast<TetrominoType>(queues[game] & 0xF));
+}
+
+int GamePool::getCurrentX(size_t game) const {
+    return current[game].x;
+}
+
+int GamePool::getCurrentY(size_t game) const {
+    return current[game].y;
+}
+
+int GamePool::getTicksUntilDrop(size_t game) const {
+    int remaining = getDropIntervalTicks(levels[game]) - gravityTicks[game];
+    return remaining > 0 ? remaining : 0;
+}
+
+Board::Row GamePool::getRow(size_t game, int y) const {
+    return static_cast<Board::Row>((boards[game].words[PAD_ROWS + y] >> GUARD_BITS) & Board::FULL_ROW);
+}
+
+size_t GamePool::getMemoryBytes() const {
+    return sizeof(GamePool)
+         + boards.capacity() * sizeof(Rows)
+         + current.capacity() * sizeof(PieceState)
+         + states.capacity() * sizeof(uint8_t)
+         + gravityTicks.capacity() * sizeof(int32_t)
+         + scores.capacity() * sizeof(int32_t)
+         + levels.capacity() * sizeof(int32_t)
+         + lines.capacity() * sizeof(int32_t)
+         + piecesPlaced.capacity() * sizeof(int64_t)
+         + tickCounts.capacity() * sizeof(int64_t)
+         + rngs.capacity() * sizeof(Random)
+         + queues.capacity() * sizeof(uint64_t)
+         + queueCounts.capacity() * sizeof(uint8_t)
+         + policies.capacity() * sizeof(uint8_t);
+}
+
+bool GamePool::canPlace(size_t game, Tetromino piece, int x, int y) const {
+    if (x <= -Tetromino::MATRIX_SIZE || x >= WIDTH || y >= HEIGHT) {
+        return false;
+    }
+    // Pieces start on row 0 and only move down, so y is never negative
+    uint64_t covered;
+    std::memcpy(&covered, &boards[game].words[PAD_ROWS + y], sizeof(covered));
+    return ((piece.getRowMaskLanes() << (x + GUARD_BITS)) & covered) == 0;
+}
+
+bool GamePool::move(size_t game, int dx, int dy) {
+    PieceState& state = current[game];
+    if (!canPlace(game, state.piece, state.x + dx, state.y + dy)) {
+        return false;
+    }
+    state.x = static_cast<int8_t>(state.x + dx);
+    state.y = static_cast<int8_t>(state.y + dy);
+    return true;
+}
+
+void GamePool::rotate(size_t game, bool clockwise) {
+    PieceState& state = current[game];
+    Tetromino rotated = state.piece;
+    if (clockwise) {
+        rotated.rotate();
+    } else {
+        rotated.rotateCounterClockwise();
+    }
+
+    const int kickCount = Game::getKickCount(clockwise);
+    for (int i = 0; i < kickCount; ++i) {
+        if (canPlace(game, rotated, state.x + Game::KICK_OFFSETS[i], state.y)) {
+            state.piece = rotated;
+            state.x = static_cast<int8_t>(state.x + Game::KICK_OFFSETS[i]);
+            return;
+        }
+    }
+}
+
+void GamePool::start(size_t game) {
+    Rows& rows = boards[game];
+    for (int y = 0; y < HEIGHT; ++y) {
+        rows.words[PAD_ROWS + y] = WALL_ROW;
+    }
+    scores[game] = 0;
+    levels[game] = 1;
+    lines[game] = 0;
+    piecesPlaced[game] = 0;
+    tickCounts[game] = 0;
+    gravityTicks[game] = 0;
+    current[game] = PieceState{drawPiece(game), (WIDTH - Tetromino::MATRIX_SIZE) / 2, 0};
+    states[game] = static_cast<uint8_t>(GameState::PLAYING);
+}
+
+void GamePool::lock(size_t game) {
+    const PieceState& state = current[game];
+    uint16_t* rows = &boards[game].words[PAD_ROWS];
+    const auto& masks = state.piece.getRowMasks();
+    for (int row = 0; row < Tetromino::MATRIX_SIZE; ++row) {
+        // The piece fits, so its cells all lie on the board
+        if (masks[row] != 0) {
+            rows[state.y + row] |= static_cast<uint16_t>(masks[row] << (state.x + GUARD_BITS));
+        }
+    }
+    ++piecesPlaced[game];
+
+    // Only the rows the piece covers can have filled up; surviving rows
+    // above them slide down over the full ones
+    int cleared = 0;
+    const int bottom = state.y + Tetromino::MATRIX_SIZE - 1 < HEIGHT ? state.y + Tetromino::MATRIX_SIZE - 1 : HEIGHT - 1;
+    for (int y = bottom; y >= 0; --y) {
+        if (cleared == 0 && y < state.y) {
+            break;
+        }
+        if (rows[y] == SOLID_ROW) {
+            ++cleared;
+        } else if (cleared > 0) {
+            rows[y + cleared] = rows[y];
+        }
+    }
+    for (int y = 0; y < cleared; ++y) {
+        rows[y] = WALL_ROW;
+    }
+
+    if (cleared > 0) {
+        scores[game] += Game::BASE_SCORE_PER_LINE[cleared] * levels[game];
+        lines[game] += cleared;
+        int newLevel = lines[game] / Game::LINES_PER_LEVEL + 1;
+        if (newLevel > levels[game]) {
+            levels[game] = newLevel;
+        }
+    }
+
+    // Blocks left in the top two rows end the game, as Board::isGameOver
+    if ((rows[0] | rows[1]) != WALL_ROW) {
+        states[game] = static_cast<uint8_t>(GameState::GAME_OVER);
+    } else {
+        spawn(game);
+    }
+}
+
+void GamePool::spawn(size_t game) {
+    PieceState& state = current[game];
+    state = PieceState{drawPiece(game), (WIDTH - Tetromino::MATRIX_SIZE) / 2, 0};
+    if (!canPlace(game, state.piece, state.x, state.y)) {
+        states[game] = static_cast<uint8_t>(GameState::GAME_OVER);
+    }
+}
+
+Tetromino GamePool::drawPiece(size_t game) {
+    // Keep the next piece queued behind the one drawn
+    if (queueCounts[game] <= 1) {
+        refillQueue(game);
+    }
+    uint64_t& queue = queues[game];
+    Tetromino piece(static_cast<TetrominoType>(queue & 0xF));
+    queue >>= 4;
+    --queueCounts[game];
+    return piece;
+}
+
+void GamePool::refillQueue(size_t game) {
+    // Pieces come off the PRNG in the order PieceGenerator draws them, so
+    // the stream is the same even though it is topped up in smaller steps
+    uint64_t& queue = queues[game];
+    uint8_t& count = queueCounts[game];
+    const PiecePolicy policy = static_cast<PiecePolicy>(policies[game]);
+    if (policy == PiecePolicy::UNIFORM) {
+        queue |= static_cast<uint64_t>(rngs[game].nextInt(PIECE_TYPES)) << (4 * count);
+        ++count;
+        return;
+    }
+
+    // Fisher-Yates over one bag; at most one piece is queued ahead of it
+    const int copies = policy == PiecePolicy::BAG_14 ? 2 : 1;
+    std::array<uint8_t, PIECE_TYPES * 2> bag;
+    const int bagSize = PIECE_TYPES * copies;
+    for (int i = 0; i < bagSize; ++i) {
+        bag[i] = static_cast<uint8_t>(i % PIECE_TYPES);
+    }
+    for (int i = bagSize - 1; i > 0; --i) {
+        int j = rngs[game].nextInt(i + 1);
+        std::swap(bag[i], bag[j]);
+    }
+    for (int i = 0; i < bagSize; ++i) {
+        queue |= static_cast<uint64_t>(bag[i]) << (4 * count);
+        ++count;
+    }
+}
+
+int GamePool::getDropIntervalTicks(int level) {
+    return dropIntervals()[level < MAX_INTERVAL_LEVEL ? level : MAX_INTERVAL_LEVEL];
+}
@@ -0,0 +1,120 @@
+#include "../../include/Sim/Policy.h"
+
+std::unique_ptr<Policy> Policy::create(const std::string& name) {
+    if (name == "random") {
+        return std::make_unique<RandomPolicy>();
+    }
+    if (name == "random-placement") {
+        return std::make_unique<RandomPlacementPolicy>();
+    }
+    if (name == "ai") {
+        return std::make_unique<AiPolicy>();
+    }
+    if (name == "ai-reachable") {
+        return std::make_unique<AiPolicy>(AutoPlayer::SearchMode::REACHABLE);
+    }
+    return nullptr;
+}
+
+std::vector<std::string> Policy::getNames() {
+    return {"random", "random-placement", "ai", "ai-reachable"};
+}
+
+const char* RandomPolicy::getName() const {
+    return "random";
+}
+
+std::unique_ptr<Policy> RandomPolicy::clone() const {
+    return std::make_unique<RandomPolicy>(*this);
+}
+
+void RandomPolicy::reset(uint64_t seed) {
+    rng.seed(seed);
+}
+
+InputAction RandomPolicy::chooseAction(const Game& game) {
+    (void)game;
+    static const InputAction ACTIONS[] = {
+        InputAction::MOVE_LEFT,
+        InputAction::MOVE_RIGHT,
+        InputAction::MOVE_DOWN,
+        InputAction::HARD_DROP,
+        InputAction::ROTATE_CW,
+        InputAction::ROTATE_CCW
+    };
+    return ACTIONS[rng.nextInt(6)];
+}
+
+RandomPlacementPolicy::RandomPlacementPolicy()
+    : plannedPiece(-1)
+    , rotationsLeft(0)
+    , targetX(0)
+    , lastX(0) {
+}
+
+const char* RandomPlacementPolicy::getName() const {
+    return "random-placement";
+}
+
+std::unique_ptr<Policy> RandomPlacementPolicy::clone() const {
+    return std::make_unique<RandomPlacementPolicy>(*this);
+}
+
+void RandomPlacementPolicy::reset(uint64_t seed) {
+    rng.seed(seed);
+    plannedPiece = -1;
+}
+
+InputAction RandomPlacementPolicy::chooseAction(const Game& game) {
+    int x = game.getCurrentX();
+
+    if (game.getPiecesPlaced() != plannedPiece) {
+        plannedPiece = game.getPiecesPlaced();
+        rotationsLeft = rng.nextInt(Tetromino::MATRIX_SIZE);
+        targetX = rng.nextInt(Board::WIDTH + 2) - 2;
+        lastX = x + 1; // anything but x, so the first move is not seen as blocked
+    }
+
+    if (rotationsLeft > 0) {
+        --rotationsLeft;
+        return InputAction::ROTATE_CW;
+    }
+
+    // A horizontal move that left x unchanged hit a wall or the stack
+    if (x == targetX || x == lastX) {
+        return InputAction::HARD_DROP;
+    }
+
+    lastX = x;
+    return x < targetX ? InputAction::MOVE_RIGHT : InputAction::MOVE_LEFT;
+}
+
+AiPolicy::AiPolicy(AutoPlayer::SearchMode mode)
+    : mode(mode)
+    , table(nullptr)
+    , player(evaluator, mode) {
+}
+
+void AiPolicy::setTranspositionTable(TranspositionTable* newTable) {
+    table = newTable;
+    player.setTranspositionTable(table);
+}
+
+const char* AiPolicy::getName() const {
+    return mode == AutoPlayer::SearchMode::REACHABLE ? "ai-reachable" : "ai";
+}
+
+std::unique_ptr<Policy> AiPolicy::clone() const {
+    auto copy = std::make_unique<AiPolicy>(mode);
+    copy->setTranspositionTable(table);
+    return copy;
+}
+
+void AiPolicy::reset(uint64_t seed) {
+    (void)seed;
+    player.reset();
+}
+
+InputAction AiPolicy::chooseAction(const Game& game) {
+    return player.chooseAction(game);
+}
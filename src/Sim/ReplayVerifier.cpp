@@ -0,0 +1,197 @@
+#include "../../include/Sim/ReplayVerifier.h"
+#include "../../include/Model/MappedFile.h"
+#include "../../include/Model/ReplayArchive.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Counts the pieces locked across restarts the way ReplayArchive numbers
+// them, from the game's own count, which a restart sets back to zero
+class PieceCounter {
+public:
+    explicit PieceCounter(const Game& game)
+        : game(game)
+        , pieces(0)
+        , lastPlaced(game.getPiecesPlaced()) {
+    }
+
+    void count() {
+        long long placed = game.getPiecesPlaced();
+        pieces += placed >= lastPlaced ? placed - lastPlaced : placed;
+        lastPlaced = placed;
+    }
+
+    long long get() const { return pieces; }
+
+private:
+    const Game& game;
+    long long pieces;
+    long long lastPlaced;
+};
+
+// Plays the replay's events before index `event`, then gravity up to
+// `tick`, counting after every event. A start or restart also counts the
+// gravity ahead of it first, so no lock is lost to the reset.
+void play(ReplayPlayer& player, const Replay& replay, size_t event, long long tick, PieceCounter& pieces) {
+    for (size_t i = player.getPlayedEvents(); i < event; ++i) {
+        const ReplayEvent& next = replay.events[i];
+        if (next.action == InputAction::START || next.action == InputAction::RESTART) {
+            player.playUntil(i, next.tick);
+            pieces.count();
+        }
+        player.playUntil(i + 1, next.tick);
+        pieces.count();
+    }
+    player.playUntil(event, tick);
+    pieces.count();
+}
+
+void addMismatch(std::string& reason, const char* field, long long actual, long long recorded) {
+    if (actual != recorded) {
+        reason += reason.empty() ? "" : ", ";
+        reason += std::string(field) + " " + std::to_string(actual) + " (recorded " + std::to_string(recorded) + ")";
+    }
+}
+
+// Compares the end of play with the recording and fills in the verdict
+void finish(ReplayVerdict& verdict, const Game& game, const ReplayPlayer& player, const PieceCounter& pieces,
+            long long agreedTick, long long agreedPiece) {
+    verdict.score = game.getScore();
+    verdict.level = game.getLevel();
+    verdict.linesCleared = game.getLinesCleared();
+    verdict.piecesPlaced = game.getPiecesPlaced();
+
+    std::string mismatches;
+    addMismatch(mismatches, "score", verdict.score, verdict.claimed.score);
+    addMismatch(mismatches, "level", verdict.level, verdict.claimed.level);
+    addMismatch(mismatches, "lines", verdict.linesCleared, verdict.claimed.linesCleared);
+    addMismatch(mismatches, "pieces", verdict.piecesPlaced, verdict.claimed.piecesPlaced);
+    if (mismatches.empty() && Replay::digest(game) != verdict.claimed.digest) {
+        mismatches = "final board or piece differs";
+    }
+
+    if (!mismatches.empty() && verdict.divergedTick < 0) {
+        verdict.agreedTick = agreedTick;
+        verdict.agreedPiece = agreedPiece;
+        verdict.divergedTick = player.getTick();
+        verdict.divergedPiece = pieces.get();
+    }
+    if (verdict.divergedTick >= 0) {
+        verdict.reason = "play diverges between tick " + std::to_string(verdict.agreedTick) + " (piece " +
+                         std::to_string(verdict.agreedPiece) + ") and tick " + std::to_string(verdict.divergedTick) +
+                         " (piece " + std::to_string(verdict.divergedPiece) + ")";
+        if (!mismatches.empty()) {
+            verdict.reason += ": " + mismatches;
+        }
+        return;
+    }
+    verdict.accepted = true;
+}
+
+void verifyReplay(const uint8_t* data, size_t size, ReplayVerdict& verdict) {
+    Replay replay;
+    if (!Replay::parse(data, size, verdict.path, replay, verdict.reason)) {
+        return;
+    }
+    verdict.claimed = replay.summary;
+    verdict.events = static_cast<long long>(replay.events.size());
+
+    Game game(replay.seed);
+    ReplayPlayer player(replay, game);
+    PieceCounter pieces(game);
+    play(player, replay, replay.events.size(), replay.summary.endTick, pieces);
+    finish(verdict, game, player, pieces, 0, 0);
+}
+
+void verifyArchive(ReplayVerdict& verdict) {
+    ReplayArchive archive;
+    if (!archive.open(verdict.path, verdict.reason)) {
+        return;
+    }
+    verdict.claimed = archive.getSummary();
+    verdict.events = archive.getEventCount();
+
+    // The events are played as each block is decoded, so the player's
+    // replay only ever holds those before the next keyframe
+    Replay replay;
+    replay.seed = archive.getSeed();
+    replay.piecePolicy = archive.getPiecePolicy();
+    replay.engineVersion = Game::ENGINE_VERSION;
+    replay.summary = archive.getSummary();
+    Game game(replay.seed);
+    ReplayPlayer player(replay, game);
+    PieceCounter pieces(game);
+
+    // Every keyframe is checked against the simulation as it is reached;
+    // the first that differs brackets the divergence with the one before
+    Game recorded(0);
+    Game::Snapshot snapshot;
+    std::vector<ReplayEvent> events;
+    const std::vector<ReplayKeyframe>& keyframes = archive.getKeyframes();
+    long long agreedTick = 0;
+    long long agreedPiece = 0;
+    for (size_t i = 0; i < keyframes.size(); ++i) {
+        if (!archive.readBlock(i, snapshot, events, verdict.reason)) {
+            return;
+        }
+        play(player, replay, replay.events.size(), keyframes[i].tick, pieces);
+        recorded.restore(snapshot);
+        bool matches = Replay::digest(recorded) == Replay::digest(game) && pieces.get() == keyframes[i].pieces;
+        if (i == 0 && !matches) {
+            verdict.reason = verdict.path + " does not start from a new game";
+            return;
+        }
+        if (verdict.divergedTick < 0) {
+            if (matches) {
+                agreedTick = keyframes[i].tick;
+                agreedPiece = keyframes[i].pieces;
+            } else {
+                verdict.agreedTick = agreedTick;
+                verdict.agreedPiece = agreedPiece;
+                verdict.divergedTick = keyframes[i].tick;
+                verdict.divergedPiece = keyframes[i].pieces;
+            }
+        }
+        replay.events.insert(replay.events.end(), events.begin(), events.end());
+    }
+    play(player, replay, replay.events.size(), verdict.claimed.endTick, pieces);
+    finish(verdict, game, player, pieces, agreedTick, agreedPiece);
+}
+}
+
+ReplayVerifier::ReplayVerifier(unsigned threadCount)
+    : pool(threadCount) {
+}
+
+unsigned ReplayVerifier::getThreadCount() const {
+    return pool.getThreadCount();
+}
+
+std::vector<ReplayVerdict> ReplayVerifier::verify(const std::vector<std::string>& paths) {
+    std::vector<ReplayVerdict> verdicts(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        pool.submit([&verdicts, &paths, i](unsigned) {
+            verdicts[i] = verifyFile(paths[i]);
+        });
+    }
+    pool.wait();
+    return verdicts;
+}
+
+ReplayVerdict ReplayVerifier::verifyFile(const std::string& path) {
+    ReplayVerdict verdict;
+    verdict.path = path;
+
+    MappedFile file;
+    if (!file.open(path, verdict.reason)) {
+        return verdict;
+    }
+    if (file.size() >= 4 && std::memcmp(file.data(), "TTRA", 4) == 0) {
+        // The archive maps the file itself
+        file.close();
+        verifyArchive(verdict);
+    } else {
+        verifyReplay(file.data(), file.size(), verdict);
+    }
+    return verdict;
+}
@@ -0,0 +1,56 @@
+#include "../../include/View/FrameBuffer.h"
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : width(width)
+    , height(height)
+    , cells(static_cast<size_t>(width) * height) {
+    clear();
+}
+
+int FrameBuffer::getWidth() const {
+    return width;
+}
+
+int FrameBuffer::getHeight() const {
+    return height;
+}
+
+void FrameBuffer::clear() {
+    for (auto& cell : cells) {
+        cell = {' ', 0};
+    }
+}
+
+void FrameBuffer::put(int x, int y, uint32_t glyph, uint8_t style) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return;
+    }
+    cells[static_cast<size_t>(y) * width + x] = {glyph, style};
+}
+
+void FrameBuffer::putText(int x, int y, const char* text, uint8_t style) {
+    // Text is already UTF-8, so each sequence is copied into a cell as-is
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    int column = x;
+
+    while (*p != 0) {
+        if (*p == '\n') {
+            ++y;
+            column = x;
+            ++p;
+            continue;
+        }
+
+        int length = 1;
+        if (*p >= 0xF0) length = 4;
+        else if (*p >= 0xE0) length = 3;
+        else if (*p >= 0xC0) length = 2;
+
+        uint32_t glyph = *p++;
+        for (int i = 1; i < length && (*p & 0xC0) == 0x80; ++i) {
+            glyph |= static_cast<uint32_t>(*p++) << (8 * i);
+        }
+
+        put(column++, y, glyph, style);
+    }
+}
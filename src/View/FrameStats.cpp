@@ -0,0 +1,157 @@
+#include "../../include/View/FrameStats.h"
+#include <cstdio>
+
+Histogram::Histogram() {
+    reset();
+}
+
+int Histogram::indexOf(uint64_t value) {
+    if (value >= MAX_VALUE) {
+        value = MAX_VALUE - 1;
+    }
+    if (value < 2 * SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    // Keep the top SUB_BUCKET_BITS + 1 bits; the shift picks the power of two
+    int shift = 0;
+    while ((value >> shift) >= 2 * SUB_BUCKETS) {
+        ++shift;
+    }
+    return shift * SUB_BUCKETS + static_cast<int>(value >> shift);
+}
+
+uint64_t Histogram::getBucketLow(int index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    return static_cast<uint64_t>(index - shift * SUB_BUCKETS) << shift;
+}
+
+uint64_t Histogram::getBucketHigh(int index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    return getBucketLow(index) + (1ULL << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    ++counts[indexOf(value)];
+    if (count == 0 || value < min) min = value;
+    if (value > max) max = value;
+    ++count;
+    sum += value;
+}
+
+void Histogram::reset() {
+    counts.fill(0);
+    count = 0;
+    min = 0;
+    max = 0;
+    sum = 0;
+}
+
+uint64_t Histogram::getCount() const {
+    return count;
+}
+
+uint64_t Histogram::getMin() const {
+    return min;
+}
+
+uint64_t Histogram::getMax() const {
+    return max;
+}
+
+double Histogram::getMean() const {
+    return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t Histogram::getPercentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    // Rank of the value wanted, 1-based, rounded up
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t high = getBucketHigh(i);
+            return high < max ? high : max;
+        }
+    }
+    return max;
+}
+
+uint64_t Histogram::getBucketCount(int index) const {
+    return counts[index];
+}
+
+void FrameStats::reset() {
+    inputNanos.reset();
+    updateNanos.reset();
+    renderNanos.reset();
+    frameBytes.reset();
+    keyLatencyNanos.reset();
+}
+
+bool FrameStats::dump(const std::string& path, std::string& error) const {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    struct Named {
+        const char* name;
+        const char* unit;
+        const Histogram& histogram;
+    };
+    const Named all[] = {
+        {"input", "ns", inputNanos},
+        {"update", "ns", updateNanos},
+        {"render", "ns", renderNanos},
+        {"frame-bytes", "bytes", frameBytes},
+        {"key-latency", "ns", keyLatencyNanos},
+    };
+
+    for (const Named& entry : all) {
+        const Histogram& h = entry.histogram;
+        std::fprintf(file, "# %s (%s)\n", entry.name, entry.unit);
+        std::fprintf(file, "count %llu  min %llu  mean %.1f  p50 %llu  p90 %llu  p99 %llu  p99.9 %llu  max %llu\n",
+                     static_cast<unsigned long long>(h.getCount()),
+                     static_cast<unsigned long long>(h.getMin()), h.getMean(),
+                     static_cast<unsigned long long>(h.getPercentile(50.0)),
+                     static_cast<unsigned long long>(h.getPercentile(90.0)),
+                     static_cast<unsigned long long>(h.getPercentile(99.0)),
+                     static_cast<unsigned long long>(h.getPercentile(99.9)),
+                     static_cast<unsigned long long>(h.getMax()));
+        // One line per non-empty bucket: range, count and cumulative share
+        uint64_t seen = 0;
+        for (int i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+            uint64_t n = h.getBucketCount(i);
+            if (n == 0) {
+                continue;
+            }
+            seen += n;
+            std::fprintf(file, "%llu %llu %llu %.4f\n",
+                         static_cast<unsigned long long>(Histogram::getBucketLow(i)),
+                         static_cast<unsigned long long>(Histogram::getBucketHigh(i)),
+                         static_cast<unsigned long long>(n),
+                         static_cast<double>(seen) / static_cast<double>(h.getCount()));
+        }
+        std::fprintf(file, "\n");
+    }
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        error = "cannot write " + path;
+    }
+    return ok;
+}
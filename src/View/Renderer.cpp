@@ -1,6 +1,8 @@
 #include "../../include/View/Renderer.h"
-#include <iostream>
-#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -8,12 +10,93 @@
 #include <unistd.h>
 #endif
 
-Renderer::Renderer() {
+#ifndef STDOUT_FILENO
+#define STDOUT_FILENO 1
+#endif
+
+// Chrome glyphs, UTF-8 encoded at compile time
+static constexpr uint32_t GLYPH_TOP_LEFT = FrameBuffer::encode(U'╔');
+static constexpr uint32_t GLYPH_TOP_RIGHT = FrameBuffer::encode(U'╗');
+static constexpr uint32_t GLYPH_BOTTOM_LEFT = FrameBuffer::encode(U'╚');
+static constexpr uint32_t GLYPH_BOTTOM_RIGHT = FrameBuffer::encode(U'╝');
+static constexpr uint32_t GLYPH_HORIZONTAL = FrameBuffer::encode(U'═');
+static constexpr uint32_t GLYPH_VERTICAL = FrameBuffer::encode(U'║');
+
+static const char SYNC_BEGIN[] = "\033[?2026h";
+static const char SYNC_END[] = "\033[?2026l";
+
+static const char* const MENU_ART = R"(
+    ╔════════════════════════════════════╗
+    ║                                    ║
+    ║   ████████╗███████╗████████╗██████╗ ║
+    ║      ██╔══╝██╔════╝   ██╔══╝██╔══██╗║
+    ║      ██║   █████╗     ██║   ██████╔╝║
+    ║      ██║   ██╔══╝     ██║   ██╔══██╗║
+    ║      ██║   ███████╗   ██║   ██║  ██║║
+    ║      ╚═╝   ╚══════╝   ╚═╝   ╚═╝  ╚═╝║
+    ║                                    ║
+    ║         TETRIS CLASSIC             ║
+    ║                                    ║
+    ╠════════════════════════════════════╣
+    ║                                    ║
+    ║     Press ENTER to Start Game      ║
+    ║     Press Q to Quit                ║
+    ║                                    ║
+    ╠════════════════════════════════════╣
+    ║         CONTROLS                   ║
+    ║                                    ║
+    ║     LEFT/RIGHT - Move piece        ║
+    ║     DOWN       - Soft drop         ║
+    ║     SPACE      - Hard drop         ║
+    ║     UP/Z       - Rotate            ║
+    ║     X          - Rotate CCW        ║
+    ║     P          - Pause             ║
+    ║     Q          - Quit              ║
+    ║                                    ║
+    ╚════════════════════════════════════╝
+)";
+
+static const char* const GAME_OVER_ART = R"(
+    ╔════════════════════════════════════╗
+    ║                                    ║
+    ║         ██████╗  █████╗ ███╗   ███╗███████╗║
+    ║        ██╔════╝ ██╔══██╗████╗ ████║██╔════╝║
+    ║        ██║  ███╗███████║██╔████╔██║█████╗  ║
+    ║        ██║   ██║██╔══██║██║╚██╔╝██║██╔══╝  ║
+    ║        ╚██████╔╝██║  ██║██║ ╚═╝ ██║███████╗║
+    ║         ╚═════╝ ╚═╝  ╚═╝╚═╝     ╚═╝╚══════╝║
+    ║                                    ║
+    ║          ██████╗ ██╗   ██╗███████╗██████╗  ║
+    ║         ██╔═══██╗██║   ██║██╔════╝██╔══██╗ ║
+    ║         ██║   ██║██║   ██║█████╗  ██████╔╝ ║
+    ║         ██║   ██║╚██╗ ██╔╝██╔══╝  ██╔══██╗ ║
+    ║         ╚██████╔╝ ╚████╔╝ ███████╗██║  ██║ ║
+    ║          ╚═════╝   ╚═══╝  ╚══════╝╚═╝  ╚═╝ ║
+    ║                                    ║
+    ╚════════════════════════════════════╝
+)";
+
+Renderer::Renderer() : Renderer(STDOUT_FILENO) {
+}
+
+Renderer::Renderer(int fd) : Renderer(Board::WIDTH, Board::HEIGHT, fd) {
+}
+
+Renderer::Renderer(int boardWidth, int boardHeight) : Renderer(boardWidth, boardHeight, STDOUT_FILENO) {
+}
+
+Renderer::Renderer(int boardWidth, int boardHeight, int fd)
+    : back(screenWidthFor(boardWidth), screenHeightFor(boardHeight))
+    , front(screenWidthFor(boardWidth), screenHeightFor(boardHeight))
+    , sink(fd)
+    , synchronizedOutput(detectSynchronizedOutput())
+    , statsOverlay(nullptr) {
     hideCursor();
 }
 
 void Renderer::clearScreen() {
 #ifdef _WIN32
+    sink.flush();
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     COORD coordScreen = {0, 0};
     DWORD cCharsWritten;
@@ -26,19 +109,19 @@ void Renderer::clearScreen() {
     GetConsoleScreenBufferInfo(hConsole, &csbi);
     FillConsoleOutputAttribute(hConsole, csbi.wAttributes, dwConSize, coordScreen, &cCharsWritten);
     SetConsoleCursorPosition(hConsole, coordScreen);
+    sink.invalidateCursor();
 #else
-    std::cout << "\033[2J\033[H";
+    sink.clearScreen();
+    sink.flush();
 #endif
+    // The terminal is now blank, which is exactly what a cleared front
+    // buffer describes
+    front.clear();
 }
 
 void Renderer::setCursorPosition(int x, int y) {
-#ifdef _WIN32
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    COORD pos = {static_cast<SHORT>(x), static_cast<SHORT>(y)};
-    SetConsoleCursorPosition(hConsole, pos);
-#else
-    std::cout << "\033[" << (y + 1) << ";" << (x + 1) << "H";
-#endif
+    sink.moveTo(x, y);
+    sink.flush();
 }
 
 void Renderer::hideCursor() {
@@ -49,7 +132,9 @@ void Renderer::hideCursor() {
     cursorInfo.bVisible = FALSE;
     SetConsoleCursorInfo(hConsole, &cursorInfo);
 #else
-    std::cout << "\033[?25l";
+    static const char HIDE_CURSOR[] = "\033[?25l";
+    sink.putBytes(HIDE_CURSOR, sizeof(HIDE_CURSOR) - 1);
+    sink.flush();
 #endif
 }
 
@@ -61,139 +146,116 @@ void Renderer::showCursor() {
     cursorInfo.bVisible = TRUE;
     SetConsoleCursorInfo(hConsole, &cursorInfo);
 #else
-    std::cout << "\033[?25h";
+    static const char SHOW_CURSOR[] = "\033[?25h";
+    sink.putBytes(SHOW_CURSOR, sizeof(SHOW_CURSOR) - 1);
+    sink.flush();
 #endif
 }
 
-void Renderer::render(const Game& game) {
-    setCursorPosition(0, 0);
-    renderBoard(game);
-    renderGhostPiece(game);
-    renderCurrentPiece(game);
-    renderSidebar(game);
+template <int W, int H>
+void Renderer::render(const BasicGame<W, H>& game) {
+    composeGame(game);
+    present();
 }
 
 void Renderer::renderMenu() {
-    clearScreen();
-    setCursorPosition(0, 0);
+    back.clear();
+    back.putText(0, 0, MENU_ART);
+    present();
+}
 
-    std::cout << R"(
-    ╔════════════════════════════════════╗
-    ║                                    ║
-    ║   ████████╗███████╗████████╗██████╗ ║
-    ║      ██╔══╝██╔════╝   ██╔══╝██╔══██╗║
-    ║      ██║   █████╗     ██║   ██████╔╝║
-    ║      ██║   ██╔══╝     ██║   ██╔══██╗║
-    ║      ██║   ███████╗   ██║   ██║  ██║║
-    ║      ╚═╝   ╚══════╝   ╚═╝   ╚═╝  ╚═╝║
-    ║                                    ║
-    ║         TETRIS CLASSIC             ║
-    ║                                    ║
-    ╠════════════════════════════════════╣
-    ║                                    ║
-    ║     Press ENTER to Start Game      ║
-    ║     Press Q to Quit                ║
-    ║                                    ║
-    ╠════════════════════════════════════╣
-    ║         CONTROLS                   ║
-    ║                                    ║
-    ║     LEFT/RIGHT - Move piece        ║
-    ║     DOWN       - Soft drop         ║
-    ║     SPACE      - Hard drop         ║
-    ║     UP/Z       - Rotate            ║
-    ║     X          - Rotate CCW        ║
-    ║     P          - Pause             ║
-    ║     Q          - Quit              ║
-    ║                                    ║
-    ╚════════════════════════════════════╝
-)";
+template <int W, int H>
+void Renderer::renderGameOver(const BasicGame<W, H>& game) {
+    back.clear();
+    back.putText(0, 0, GAME_OVER_ART);
+
+    char line[64];
+    int y = 19;
+    std::snprintf(line, sizeof(line), "         Final Score: %d", game.getScore());
+    back.putText(0, y++, line);
+    std::snprintf(line, sizeof(line), "         Level:       %d", game.getLevel());
+    back.putText(0, y++, line);
+    std::snprintf(line, sizeof(line), "         Lines:       %d", game.getLinesCleared());
+    back.putText(0, y++, line);
+    y++;
+    back.putText(0, y++, "         Press R to Restart");
+    back.putText(0, y++, "         Press Q to Quit");
+
+    present();
 }
 
-void Renderer::renderGameOver(const Game& game) {
-    clearScreen();
-    setCursorPosition(0, 0);
+template <int W, int H>
+void Renderer::renderPaused(const BasicGame<W, H>& game) {
+    composeGame(game);
 
-    std::cout << R"(
-    ╔════════════════════════════════════╗
-    ║                                    ║
-    ║         ██████╗  █████╗ ███╗   ███╗███████╗║
-    ║        ██╔════╝ ██╔══██╗████╗ ████║██╔════╝║
-    ║        ██║  ███╗███████║██╔████╔██║█████╗  ║
-    ║        ██║   ██║██╔══██║██║╚██╔╝██║██╔══╝  ║
-    ║        ╚██████╔╝██║  ██║██║ ╚═╝ ██║███████╗║
-    ║         ╚═════╝ ╚═╝  ╚═╝╚═╝     ╚═╝╚══════╝║
-    ║                                    ║
-    ║          ██████╗ ██╗   ██╗███████╗██████╗  ║
-    ║         ██╔═══██╗██║   ██║██╔════╝██╔══██╗ ║
-    ║         ██║   ██║██║   ██║█████╗  ██████╔╝ ║
-    ║         ██║   ██║╚██╗ ██╔╝██╔══╝  ██╔══██╗ ║
-    ║         ╚██████╔╝ ╚████╔╝ ███████╗██║  ██║ ║
-    ║          ╚═════╝   ╚═══╝  ╚══════╝╚═╝  ╚═╝ ║
-    ║                                    ║
-    ╚════════════════════════════════════╝
-)";
+    int centerX = BOARD_OFFSET_X + W;
+    int centerY = H / 2;
+
+    back.putText(centerX - 4, centerY, "╔══════════╗");
+    back.putText(centerX - 4, centerY + 1, "║  PAUSED  ║");
+    back.putText(centerX - 4, centerY + 2, "╚══════════╝");
+    back.putText(centerX - 6, centerY + 4, "Press P to Resume");
 
-    std::cout << "\n";
-    std::cout << "         Final Score: " << game.getScore() << "\n";
-    std::cout << "         Level:       " << game.getLevel() << "\n";
-    std::cout << "         Lines:       " << game.getLinesCleared() << "\n";
-    std::cout << "\n";
-    std::cout << "         Press R to Restart\n";
-    std::cout << "         Press Q to Quit\n";
+    present();
 }
 
-void Renderer::renderPaused(const Game& game) {
-    (void)game; // Parameter reserved for future use (e.g., showing score during pause)
-    int centerX = BOARD_OFFSET_X + Board::WIDTH;
-    int centerY = 10;
+template <int W, int H>
+void Renderer::composeGame(const BasicGame<W, H>& game) {
+    // Later layers overwrite earlier ones in the buffer, so the ghost and
+    // the falling piece never flicker over the board on screen
+    back.clear();
+    renderBoard(game);
+    renderGhostPiece(game);
+    renderCurrentPiece(game);
+    renderSidebar(game);
+    if (statsOverlay) {
+        renderStats(statsXFor(W), STATS_Y);
+    }
+}
 
-    setCursorPosition(centerX - 4, centerY);
-    std::cout << "╔══════════╗";
-    setCursorPosition(centerX - 4, centerY + 1);
-    std::cout << "║  PAUSED  ║";
-    setCursorPosition(centerX - 4, centerY + 2);
-    std::cout << "╚══════════╝";
-    setCursorPosition(centerX - 6, centerY + 4);
-    std::cout << "Press P to Resume";
+void Renderer::putBlock(int screenX, int screenY, uint8_t style) {
+    back.put(screenX, screenY, '[', style);
+    back.put(screenX + 1, screenY, ']', style);
 }
 
-void Renderer::renderBoard(const Game& game) {
-    const auto& grid = game.getBoard().getGrid();
+template <int W, int H>
+void Renderer::renderBoard(const BasicGame<W, H>& game) {
+    const BasicBoard<W, H>& board = game.getBoard();
+    const int right = BOARD_OFFSET_X + 1 + W * 2;
 
     // Top border
-    setCursorPosition(BOARD_OFFSET_X, BOARD_OFFSET_Y);
-    std::cout << "╔";
-    for (int i = 0; i < Board::WIDTH * 2; ++i) std::cout << "═";
-    std::cout << "╗";
+    back.put(BOARD_OFFSET_X, BOARD_OFFSET_Y, GLYPH_TOP_LEFT);
+    for (int i = 0; i < W * 2; ++i) back.put(BOARD_OFFSET_X + 1 + i, BOARD_OFFSET_Y, GLYPH_HORIZONTAL);
+    back.put(right, BOARD_OFFSET_Y, GLYPH_TOP_RIGHT);
 
     // Board content
-    for (int y = 0; y < Board::HEIGHT; ++y) {
-        setCursorPosition(BOARD_OFFSET_X, BOARD_OFFSET_Y + y + 1);
-        std::cout << "║";
+    for (int y = 0; y < H; ++y) {
+        int screenY = BOARD_OFFSET_Y + y + 1;
+        back.put(BOARD_OFFSET_X, screenY, GLYPH_VERTICAL);
 
-        for (int x = 0; x < Board::WIDTH; ++x) {
-            int cell = grid[y][x];
+        const typename BasicBoard<W, H>::ColorRow& row = board.getColorRow(y);
+        for (int x = 0; x < W; ++x) {
+            int cell = row[x];
             if (cell != 0) {
-                std::cout << getColorCode(cell) << "[]" << "\033[0m";
-            } else {
-                std::cout << "  ";
+                putBlock(BOARD_OFFSET_X + 1 + x * 2, screenY, static_cast<uint8_t>(cell));
             }
         }
-        std::cout << "║";
+        back.put(right, screenY, GLYPH_VERTICAL);
     }
 
     // Bottom border
-    setCursorPosition(BOARD_OFFSET_X, BOARD_OFFSET_Y + Board::HEIGHT + 1);
-    std::cout << "╚";
-    for (int i = 0; i < Board::WIDTH * 2; ++i) std::cout << "═";
-    std::cout << "╝";
+    int bottom = BOARD_OFFSET_Y + H + 1;
+    back.put(BOARD_OFFSET_X, bottom, GLYPH_BOTTOM_LEFT);
+    for (int i = 0; i < W * 2; ++i) back.put(BOARD_OFFSET_X + 1 + i, bottom, GLYPH_HORIZONTAL);
+    back.put(right, bottom, GLYPH_BOTTOM_RIGHT);
 }
 
-void Renderer::renderCurrentPiece(const Game& game) {
+template <int W, int H>
+void Renderer::renderCurrentPiece(const BasicGame<W, H>& game) {
     const auto& shape = game.getCurrentTetromino().getShape();
     int pieceX = game.getCurrentX();
     int pieceY = game.getCurrentY();
-    int colorValue = static_cast<int>(game.getCurrentTetromino().getType()) + 1;
+    uint8_t colorValue = static_cast<uint8_t>(static_cast<int>(game.getCurrentTetromino().getType()) + 1);
 
     for (int y = 0; y < Tetromino::MATRIX_SIZE; ++y) {
         for (int x = 0; x < Tetromino::MATRIX_SIZE; ++x) {
@@ -201,16 +263,16 @@ void Renderer::renderCurrentPiece(const Game& game) {
                 int screenX = BOARD_OFFSET_X + 1 + (pieceX + x) * 2;
                 int screenY = BOARD_OFFSET_Y + 1 + pieceY + y;
 
-                if (pieceY + y >= 0 && pieceY + y < Board::HEIGHT) {
-                    setCursorPosition(screenX, screenY);
-                    std::cout << getColorCode(colorValue) << "[]" << "\033[0m";
+                if (pieceY + y >= 0 && pieceY + y < H) {
+                    putBlock(screenX, screenY, colorValue);
                 }
             }
         }
     }
 }
 
-void Renderer::renderGhostPiece(const Game& game) {
+template <int W, int H>
+void Renderer::renderGhostPiece(const BasicGame<W, H>& game) {
     const auto& shape = game.getCurrentTetromino().getShape();
     int pieceX = game.getCurrentX();
     int ghostY = game.getGhostY();
@@ -224,110 +286,311 @@ void Renderer::renderGhostPiece(const Game& game) {
                 int screenX = BOARD_OFFSET_X + 1 + (pieceX + x) * 2;
                 int screenY = BOARD_OFFSET_Y + 1 + ghostY + y;
 
-                if (ghostY + y >= 0 && ghostY + y < Board::HEIGHT) {
-                    setCursorPosition(screenX, screenY);
-                    std::cout << "\033[90m" << ".." << "\033[0m"; // Dark gray ghost
+                if (ghostY + y >= 0 && ghostY + y < H) {
+                    back.put(screenX, screenY, '.', TerminalSink::STYLE_GHOST);
+                    back.put(screenX + 1, screenY, '.', TerminalSink::STYLE_GHOST);
                 }
             }
         }
     }
 }
 
-void Renderer::renderSidebar(const Game& game) {
-    int sidebarX = BOARD_OFFSET_X + Board::WIDTH * 2 + 5;
+template <int W, int H>
+void Renderer::renderSidebar(const BasicGame<W, H>& game) {
+    int sidebarX = sidebarXFor(W);
     int y = BOARD_OFFSET_Y + 1;
+    char line[64];
 
     // Next piece
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╔═══════════╗";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║   NEXT    ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╠═══════════╣";
+    back.putText(sidebarX, y++, "╔═══════════╗");
+    back.putText(sidebarX, y++, "║   NEXT    ║");
+    back.putText(sidebarX, y++, "╠═══════════╣");
 
     renderNextPiece(game.getNextTetromino(), sidebarX + 2, y);
     y += 4;
 
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╚═══════════╝";
+    back.putText(sidebarX, y++, "╚═══════════╝");
     y++;
 
+    // Pieces after the next one, when a deeper preview was asked for
+    if (game.getPreviewDepth() > 1) {
+        renderQueue(game, sidebarX + 15, BOARD_OFFSET_Y + 1);
+    }
+
     // Score
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╔═══════════╗";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║   SCORE   ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╠═══════════╣";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║ " << std::setw(9) << game.getScore() << " ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╚═══════════╝";
+    back.putText(sidebarX, y++, "╔═══════════╗");
+    back.putText(sidebarX, y++, "║   SCORE   ║");
+    back.putText(sidebarX, y++, "╠═══════════╣");
+    std::snprintf(line, sizeof(line), "║ %9d ║", game.getScore());
+    back.putText(sidebarX, y++, line);
+    back.putText(sidebarX, y++, "╚═══════════╝");
     y++;
 
     // Level
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╔═══════════╗";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║   LEVEL   ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╠═══════════╣";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║     " << std::setw(2) << game.getLevel() << "    ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╚═══════════╝";
+    back.putText(sidebarX, y++, "╔═══════════╗");
+    back.putText(sidebarX, y++, "║   LEVEL   ║");
+    back.putText(sidebarX, y++, "╠═══════════╣");
+    std::snprintf(line, sizeof(line), "║     %2d    ║", game.getLevel());
+    back.putText(sidebarX, y++, line);
+    back.putText(sidebarX, y++, "╚═══════════╝");
     y++;
 
     // Lines
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╔═══════════╗";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║   LINES   ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╠═══════════╣";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "║ " << std::setw(9) << game.getLinesCleared() << " ║";
-    setCursorPosition(sidebarX, y++);
-    std::cout << "╚═══════════╝";
+    back.putText(sidebarX, y++, "╔═══════════╗");
+    back.putText(sidebarX, y++, "║   LINES   ║");
+    back.putText(sidebarX, y++, "╠═══════════╣");
+    std::snprintf(line, sizeof(line), "║ %9d ║", game.getLinesCleared());
+    back.putText(sidebarX, y++, line);
+    back.putText(sidebarX, y++, "╚═══════════╝");
 }
 
 void Renderer::renderNextPiece(const Tetromino& tetromino, int startX, int startY) {
     const auto& shape = tetromino.getShape();
-    int colorValue = static_cast<int>(tetromino.getType()) + 1;
+    uint8_t colorValue = static_cast<uint8_t>(static_cast<int>(tetromino.getType()) + 1);
 
     for (int y = 0; y < Tetromino::MATRIX_SIZE; ++y) {
-        setCursorPosition(startX - 1, startY + y);
-        std::cout << "║";
+        back.put(startX - 1, startY + y, GLYPH_VERTICAL);
         for (int x = 0; x < Tetromino::MATRIX_SIZE; ++x) {
             if (shape[y][x] != 0) {
-                std::cout << getColorCode(colorValue) << "[]" << "\033[0m";
-            } else {
-                std::cout << "  ";
+                putBlock(startX + x * 2, startY + y, colorValue);
             }
         }
-        std::cout << " ║";
+        back.put(startX + Tetromino::MATRIX_SIZE * 2 + 1, startY + y, GLYPH_VERTICAL);
     }
 }
 
-std::string Renderer::getColorCode(int value) const {
-    // ANSI color codes for different tetromino types
-    switch (value) {
-        case 1: return "\033[96m";  // I - Cyan
-        case 2: return "\033[93m";  // O - Yellow
-        case 3: return "\033[95m";  // T - Magenta
-        case 4: return "\033[92m";  // S - Green
-        case 5: return "\033[91m";  // Z - Red
-        case 6: return "\033[94m";  // J - Blue
-        case 7: return "\033[33m";  // L - Orange (dark yellow)
-        default: return "\033[97m"; // White
+template <int W, int H>
+void Renderer::renderQueue(const BasicGame<W, H>& game, int startX, int startY) {
+    int y = startY;
+    back.putText(startX, y++, "╔═══════════╗");
+    back.putText(startX, y++, "║   QUEUE   ║");
+    back.putText(startX, y++, "╠═══════════╣");
+
+    // Two rows per piece are enough for spawn orientations
+    int shown = std::min(game.getPreviewDepth(), MAX_PREVIEW_SHOWN);
+    for (int i = 1; i < shown; ++i) {
+        const Tetromino& tetromino = game.getPreview(i);
+        const auto& shape = tetromino.getShape();
+        int top = tetromino.getBounds().minY;
+        uint8_t colorValue = static_cast<uint8_t>(static_cast<int>(tetromino.getType()) + 1);
+
+        for (int row = 0; row < 3; ++row, ++y) {
+            back.put(startX, y, GLYPH_VERTICAL);
+            back.put(startX + 12, y, GLYPH_VERTICAL);
+            if (row == 2 || top + row >= Tetromino::MATRIX_SIZE) continue;
+            for (int x = 0; x < Tetromino::MATRIX_SIZE; ++x) {
+                if (shape[top + row][x] != 0) {
+                    putBlock(startX + 2 + x * 2, y, colorValue);
+                }
+            }
+        }
+    }
+
+    back.putText(startX, y, "╚═══════════╝");
+}
+
+namespace {
+// Fits a duration in seven columns: 850ns, 12.3us, 4.56ms, 1.20s
+void formatNanos(char* out, size_t size, uint64_t nanos) {
+    if (nanos < 1000) {
+        std::snprintf(out, size, "%lluns", static_cast<unsigned long long>(nanos));
+    } else if (nanos < 1000000) {
+        std::snprintf(out, size, "%.1fus", nanos / 1e3);
+    } else if (nanos < 1000000000) {
+        std::snprintf(out, size, "%.2fms", nanos / 1e6);
+    } else {
+        std::snprintf(out, size, "%.2fs", nanos / 1e9);
     }
 }
 
+void formatBytes(char* out, size_t size, uint64_t bytes) {
+    if (bytes < 10000) {
+        std::snprintf(out, size, "%lluB", static_cast<unsigned long long>(bytes));
+    } else {
+        std::snprintf(out, size, "%.1fKB", bytes / 1024.0);
+    }
+}
+}
+
+void Renderer::renderStats(int startX, int startY) {
+    struct Row {
+        const char* label;
+        const Histogram& histogram;
+        bool bytes;
+    };
+    const Row rows[] = {
+        {"input", statsOverlay->inputNanos, false},
+        {"update", statsOverlay->updateNanos, false},
+        {"render", statsOverlay->renderNanos, false},
+        {"latency", statsOverlay->keyLatencyNanos, false},
+        {"output", statsOverlay->frameBytes, true},
+    };
+
+    int y = startY;
+    char line[96];
+    back.putText(startX, y++, "╔═════════════ TIMING ═════════════╗");
+    back.putText(startX, y++, "║              p50     p99     max ║");
+    for (const Row& row : rows) {
+        char p50[16];
+        char p99[16];
+        char max[16];
+        auto format = row.bytes ? formatBytes : formatNanos;
+        format(p50, sizeof(p50), row.histogram.getPercentile(50.0));
+        format(p99, sizeof(p99), row.histogram.getPercentile(99.0));
+        format(max, sizeof(max), row.histogram.getMax());
+        std::snprintf(line, sizeof(line), "║ %-8s %7s %7s %7s ║", row.label, p50, p99, max);
+        back.putText(startX, y++, line);
+    }
+    std::snprintf(line, sizeof(line), "║ frames %-10llu keys %-9llu ║",
+                  static_cast<unsigned long long>(statsOverlay->renderNanos.getCount()),
+                  static_cast<unsigned long long>(statsOverlay->keyLatencyNanos.getCount()));
+    back.putText(startX, y++, line);
+    back.putText(startX, y, "╚══════════════════════════════════╝");
+}
+
+int Renderer::screenWidthFor(int boardWidth) {
+    int needed = statsXFor(boardWidth) + STATS_WIDTH;
+    return needed > SCREEN_WIDTH ? needed : SCREEN_WIDTH;
+}
+
+int Renderer::screenHeightFor(int boardHeight) {
+    // The board with its borders, or the stats overlay, whichever is lower
+    int needed = BOARD_OFFSET_Y + boardHeight + 2;
+    if (STATS_Y + STATS_HEIGHT > needed) needed = STATS_Y + STATS_HEIGHT;
+    return needed > SCREEN_HEIGHT ? needed : SCREEN_HEIGHT;
+}
+
+int Renderer::sidebarXFor(int boardWidth) {
+    return BOARD_OFFSET_X + boardWidth * 2 + 5;
+}
+
+int Renderer::statsXFor(int boardWidth) {
+    // Under the queue column, clear of the deepest preview
+    return sidebarXFor(boardWidth) + 15;
+}
+
+void Renderer::present() {
+    bool changed = false;
+    int nextX = -1;   // column just after the last cell written on row y
+    uint8_t style = TerminalSink::STYLE_DEFAULT;
+
+    const int width = back.getWidth();
+    const int height = back.getHeight();
+    for (int y = 0; y < height; ++y) {
+        nextX = -1;
+        for (int x = 0; x < width; ++x) {
+            const FrameBuffer::Cell& cell = back.at(x, y);
+            if (cell == front.at(x, y)) {
+                continue;
+            }
+
+            if (!changed && synchronizedOutput) {
+                sink.putBytes(SYNC_BEGIN, sizeof(SYNC_BEGIN) - 1);
+            }
+            changed = true;
+
+            // Re-sending a short run of unchanged ASCII cells is cheaper than
+            // a cursor move, as long as the active style doesn't alter them
+            if (nextX >= 0 && x - nextX <= GAP_FILL_LIMIT) {
+                bool fillable = true;
+                for (int gx = nextX; gx < x && fillable; ++gx) {
+                    const FrameBuffer::Cell& gap = back.at(gx, y);
+                    fillable = gap.glyph < 0x80 && (gap.glyph == ' ' || gap.style == style);
+                }
+                for (int gx = nextX; gx < x && fillable; ++gx) {
+                    sink.putGlyph(back.at(gx, y).glyph);
+                }
+            }
+
+            sink.moveTo(x, y);
+            sink.setStyle(cell.style);
+            sink.putGlyph(cell.glyph);
+            style = cell.style;
+            nextX = x + 1;
+            if (x == width - 1) {
+                // Terminals differ on where the cursor sits after the last
+                // column, so don't rely on it
+                sink.invalidateCursor();
+            }
+        }
+    }
+
+    std::swap(front, back);
+
+    if (!changed) {
+        return;
+    }
+
+    // The terminal is left in the default style between frames
+    sink.setStyle(TerminalSink::STYLE_DEFAULT);
+    if (synchronizedOutput) {
+        sink.putBytes(SYNC_END, sizeof(SYNC_END) - 1);
+    }
+    sink.flush();
+}
+
+void Renderer::setStatsOverlay(const FrameStats* stats) {
+    statsOverlay = stats;
+}
+
+const TerminalSink& Renderer::getSink() const {
+    return sink;
+}
+
+void Renderer::setOutbox(std::vector<char>* outbox) {
+    sink.setOutbox(outbox);
+}
+
+size_t Renderer::getMemoryBytes() const {
+    size_t cells = static_cast<size_t>(back.getWidth()) * static_cast<size_t>(back.getHeight());
+    return 2 * cells * sizeof(FrameBuffer::Cell) + sink.getCapacity();
+}
+
+bool Renderer::detectSynchronizedOutput() {
+    // Mode 2026 has no reliable synchronous query, so go by the terminals
+    // known to implement it; TETRIS_SYNC_OUTPUT=0/1 overrides the guess
+    const char* overrideValue = std::getenv("TETRIS_SYNC_OUTPUT");
+    if (overrideValue != nullptr) {
+        return std::strcmp(overrideValue, "0") != 0;
+    }
+
+    const char* program = std::getenv("TERM_PROGRAM");
+    if (program != nullptr) {
+        static const char* const PROGRAMS[] = {"WezTerm", "iTerm.app", "vscode", "ghostty", "contour", "tmux"};
+        for (const char* known : PROGRAMS) {
+            if (std::strcmp(program, known) == 0) return true;
+        }
+    }
+
+    const char* term = std::getenv("TERM");
+    if (term != nullptr) {
+        static const char* const TERMS[] = {"kitty", "foot", "alacritty", "ghostty", "contour", "wezterm"};
+        for (const char* known : TERMS) {
+            if (std::strstr(term, known) != nullptr) return true;
+        }
+    }
+    return false;
+}
+
 char Renderer::getCellChar(int value) const {
     if (value == 0) return ' ';
     return '#';
 }
 
 void Renderer::resetColor() {
-    std::cout << "\033[0m";
+    sink.setStyle(TerminalSink::STYLE_DEFAULT);
+    sink.flush();
 }
+
+template void Renderer::render(const BasicGame<10, 20>&);
+template void Renderer::render(const BasicGame<10, 40>&);
+template void Renderer::render(const BasicGame<16, 20>&);
+template void Renderer::render(const BasicGame<32, 20>&);
+template void Renderer::renderGameOver(const BasicGame<10, 20>&);
+template void Renderer::renderGameOver(const BasicGame<10, 40>&);
+template void Renderer::renderGameOver(const BasicGame<16, 20>&);
+template void Renderer::renderGameOver(const BasicGame<32, 20>&);
+template void Renderer::renderPaused(const BasicGame<10, 20>&);
+template void Renderer::renderPaused(const BasicGame<10, 40>&);
+template void Renderer::renderPaused(const BasicGame<16, 20>&);
+template void Renderer::renderPaused(const BasicGame<32, 20>&);
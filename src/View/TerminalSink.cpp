@@ -0,0 +1,246 @@
+#include "../../include/View/TerminalSink.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace {
+struct EscapeBlob {
+    const char* bytes;
+    size_t length;
+};
+
+// Pre-encoded SGR sequences indexed by style
+const EscapeBlob STYLE_SEQUENCES[TerminalSink::STYLE_COUNT] = {
+    {"\033[0m", 4},   // Default
+    {"\033[96m", 5},  // I - Cyan
+    {"\033[93m", 5},  // O - Yellow
+    {"\033[95m", 5},  // T - Magenta
+    {"\033[92m", 5},  // S - Green
+    {"\033[91m", 5},  // Z - Red
+    {"\033[94m", 5},  // J - Blue
+    {"\033[33m", 5},  // L - Orange (dark yellow)
+    {"\033[90m", 5},  // Ghost - Dark gray
+    {"\033[97m", 5}   // White
+};
+
+const EscapeBlob CLEAR_SCREEN = {"\033[2J\033[H", 7};
+}
+
+TerminalSink::TerminalSink(int fd)
+    : fd(fd)
+    , outbox(nullptr)
+    , buffer(16384)
+    , used(0)
+    , cursorX(-1)
+    , cursorY(-1)
+    , style(-1)
+    , lastFrameBytes(0)
+    , lastFrameSyscalls(0)
+    , totalBytes(0)
+    , totalSyscalls(0)
+    , frameCount(0) {
+}
+
+char* TerminalSink::reserve(size_t length) {
+    // Grows only past the high-water mark, so steady-state frames never
+    // allocate
+    if (used + length > buffer.size()) {
+        buffer.resize(std::max(buffer.size() * 2, used + length));
+    }
+    char* out = buffer.data() + used;
+    used += length;
+    return out;
+}
+
+int TerminalSink::countDigits(int value) {
+    int digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+char* TerminalSink::writeNumber(char* out, int value) {
+    int digits = countDigits(value);
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + digits;
+}
+
+void TerminalSink::appendCsi(int value, char final) {
+    // A parameter of 1 is the default and can be left out
+    int digits = value > 1 ? countDigits(value) : 0;
+    char* out = reserve(3 + static_cast<size_t>(digits));
+    *out++ = '\033';
+    *out++ = '[';
+    if (value > 1) out = writeNumber(out, value);
+    *out = final;
+}
+
+void TerminalSink::moveTo(int x, int y) {
+    if (x == cursorX && y == cursorY) {
+        return;
+    }
+
+    // Absolute CUP: ESC [ row ; col H, with defaults for row/col 1
+    int absoluteCost = 3 + (y > 0 ? countDigits(y + 1) : 0) + (x > 0 ? 1 + countDigits(x + 1) : 0);
+
+    if (cursorX >= 0) {
+        auto stepCost = [](int distance) {
+            return distance == 0 ? 0 : 3 + (distance > 1 ? countDigits(distance) : 0);
+        };
+        int dy = y - cursorY;
+        int dx = x - cursorX;
+        int verticalCost = stepCost(dy < 0 ? -dy : dy);
+        int relativeCost = stepCost(dx < 0 ? -dx : dx);
+        int returnCost = 1 + stepCost(x);   // CR, then forward from column 0
+
+        if (verticalCost + std::min(relativeCost, returnCost) < absoluteCost) {
+            if (dy != 0) {
+                appendCsi(dy < 0 ? -dy : dy, dy < 0 ? 'A' : 'B');
+            }
+            if (relativeCost <= returnCost) {
+                if (dx != 0) appendCsi(dx < 0 ? -dx : dx, dx < 0 ? 'D' : 'C');
+            } else {
+                *reserve(1) = '\r';
+                if (x != 0) appendCsi(x, 'C');
+            }
+            cursorX = x;
+            cursorY = y;
+            return;
+        }
+    }
+
+    char* out = reserve(static_cast<size_t>(absoluteCost));
+    *out++ = '\033';
+    *out++ = '[';
+    if (y > 0) out = writeNumber(out, y + 1);
+    if (x > 0) {
+        *out++ = ';';
+        out = writeNumber(out, x + 1);
+    }
+    *out = 'H';
+
+    cursorX = x;
+    cursorY = y;
+}
+
+void TerminalSink::setStyle(uint8_t newStyle) {
+    if (newStyle == style) {
+        return;
+    }
+    const EscapeBlob& sequence = STYLE_SEQUENCES[newStyle < STYLE_COUNT ? newStyle : STYLE_DEFAULT];
+    std::memcpy(reserve(sequence.length), sequence.bytes, sequence.length);
+    style = newStyle;
+}
+
+void TerminalSink::putGlyph(uint32_t glyph) {
+    char* out = reserve(4);
+    size_t length = 0;
+    do {
+        out[length++] = static_cast<char>(glyph & 0xFF);
+        glyph >>= 8;
+    } while (glyph != 0 && length < 4);
+    used -= 4 - length;
+
+    if (cursorX >= 0) {
+        ++cursorX;
+    }
+}
+
+void TerminalSink::putBytes(const char* bytes, size_t length) {
+    std::memcpy(reserve(length), bytes, length);
+}
+
+void TerminalSink::invalidateCursor() {
+    cursorX = -1;
+    cursorY = -1;
+}
+
+void TerminalSink::clearScreen() {
+    // Erased cells take the current background, so reset the style first
+    setStyle(STYLE_DEFAULT);
+    putBytes(CLEAR_SCREEN.bytes, CLEAR_SCREEN.length);
+    cursorX = 0;
+    cursorY = 0;
+}
+
+bool TerminalSink::hasPendingOutput() const {
+    return used > 0;
+}
+
+void TerminalSink::flush() {
+    unsigned syscalls = 0;
+
+    if (outbox) {
+        outbox->insert(outbox->end(), buffer.data(), buffer.data() + used);
+    } else if (fd >= 0) {
+        const char* data = buffer.data();
+        size_t remaining = used;
+        while (remaining > 0) {
+#ifdef _WIN32
+            int written = _write(fd, data, static_cast<unsigned>(remaining));
+#else
+            ssize_t written = ::write(fd, data, remaining);
+#endif
+            ++syscalls;
+            if (written < 0) {
+#ifndef _WIN32
+                if (errno == EINTR || errno == EAGAIN) continue;
+#endif
+                break;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+
+    lastFrameBytes = used;
+    lastFrameSyscalls = syscalls;
+    totalBytes += used;
+    totalSyscalls += syscalls;
+    ++frameCount;
+    used = 0;
+}
+
+void TerminalSink::setOutbox(std::vector<char>* newOutbox) {
+    outbox = newOutbox;
+    // Frames are copied out whole, so staging only has to hold one; start
+    // small and let reserve() grow to the largest frame actually drawn
+    if (outbox && used <= OUTBOX_STAGING_SIZE) {
+        std::vector<char>(buffer.begin(), buffer.begin() + OUTBOX_STAGING_SIZE).swap(buffer);
+    }
+}
+
+size_t TerminalSink::getCapacity() const {
+    return buffer.capacity();
+}
+
+size_t TerminalSink::getLastFrameBytes() const {
+    return lastFrameBytes;
+}
+
+unsigned TerminalSink::getLastFrameSyscalls() const {
+    return lastFrameSyscalls;
+}
+
+uint64_t TerminalSink::getTotalBytes() const {
+    return totalBytes;
+}
+
+uint64_t TerminalSink::getTotalSyscalls() const {
+    return totalSyscalls;
+}
+
+uint64_t TerminalSink::getFrameCount() const {
+    return frameCount;
+}
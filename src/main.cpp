@@ -1,24 +1,189 @@
 #include "../include/Controller/GameController.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <string>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
-int main() {
-#ifdef _WIN32
-    // Set console to UTF-8 mode for proper Unicode character rendering
-    SetConsoleOutputCP(CP_UTF8);
-    SetConsoleCP(CP_UTF8);
-#endif
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --pieces NAME    piece generator: uniform, 7-bag or 14-bag (default uniform)\n"
+              << "  --preview N      upcoming pieces to show, 1-" << Renderer::MAX_PREVIEW_SHOWN << " (default 1)\n"
+              << "  --board SIZE     playfield: 10x20, 10x40, 16x20 or 32x20 (default 10x20);\n"
+              << "                   --ai, --record, --archive and --replay need 10x20\n"
+              << "  --ai             let the autoplayer make the moves\n"
+              << "  --record FILE    save the session as a replay on exit\n"
+              << "  --archive FILE   save it as a seekable replay archive on exit\n"
+              << "  --stats FILE     write frame timing and key latency histograms on exit\n"
+              << "                   (F toggles the live figures in game)\n"
+              << "  --replay FILE    play a recorded session (replay or archive) back in real time\n"
+              << "  --headless       with --replay: run it as fast as possible and\n"
+              << "                   check the result against the recording\n";
+}
+
+// Replays without a terminal and reports whether the outcome matched
+static int runHeadlessReplay(const Replay& replay) {
+    Game game(replay.seed);
+    ReplayPlayer player(replay, game);
+
+    auto start = std::chrono::steady_clock::now();
+    player.runToEnd();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    bool matches = player.matchesRecording();
+    std::cout << "seed      " << replay.seed << "\n"
+              << "generator " << PieceGenerator::getPolicyName(replay.piecePolicy) << "\n"
+              << "events    " << replay.events.size() << "\n"
+              << "ticks     " << replay.summary.endTick << "\n"
+              << "score     " << game.getScore() << " (recorded " << replay.summary.score << ")\n"
+              << "level     " << game.getLevel() << " (recorded " << replay.summary.level << ")\n"
+              << "lines     " << game.getLinesCleared() << " (recorded " << replay.summary.linesCleared << ")\n"
+              << "pieces    " << game.getPiecesPlaced() << " (recorded " << replay.summary.piecesPlaced << ")\n"
+              << "elapsed   " << elapsed.count() * 1000.0 << " ms\n"
+              << "result    " << (matches ? "match" : "MISMATCH") << "\n";
+    return matches ? 0 : 1;
+}
+
+struct SessionOptions {
+    std::string recordPath;
+    std::string archivePath;
+    std::string statsPath;
+    std::string replayPath;
+    bool autoPlay = false;
+    PiecePolicy piecePolicy = PiecePolicy::UNIFORM;
+    int previewDepth = 1;
+};
 
+// Runs the terminal game on a W x H board; the board size is fixed for the
+// session, so it is picked once here rather than checked on every move
+template <int W, int H>
+static int runSession(const SessionOptions& options, const Replay& replay) {
+    std::string recordError;
+    std::string statsError;
     try {
-        GameController controller;
-        controller.run();
+        BasicGameController<W, H> controller;
+        controller.setPreviewDepth(options.previewDepth);
+        if (!options.replayPath.empty()) {
+            controller.runReplay(replay);
+        } else {
+            controller.setPiecePolicy(options.piecePolicy);
+            if (options.autoPlay) {
+                controller.enableAutoPlay();
+            }
+            if (!options.recordPath.empty()) {
+                controller.startRecording();
+            }
+            if (!options.archivePath.empty()) {
+                controller.startArchiving();
+            }
+            controller.run();
+            if (!options.recordPath.empty()) {
+                controller.saveRecording(options.recordPath, recordError);
+            }
+            if (!options.archivePath.empty() && recordError.empty()) {
+                controller.saveArchive(options.archivePath, recordError);
+            }
+            if (!options.statsPath.empty()) {
+                controller.getFrameStats().dump(options.statsPath, statsError);
+            }
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
 
+    // Reported once the controller has restored the terminal
+    if (!recordError.empty() || !statsError.empty()) {
+        std::cerr << "Error: " << (recordError.empty() ? statsError : recordError) << std::endl;
+        return 1;
+    }
+
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    SessionOptions options;
+    bool headless = false;
+    std::string boardSize = "10x20";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--pieces") == 0 && hasValue) {
+            if (!PieceGenerator::parsePolicy(argv[++i], options.piecePolicy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--preview") == 0 && hasValue) {
+            options.previewDepth = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--board") == 0 && hasValue) {
+            boardSize = argv[++i];
+        } else if (std::strcmp(arg, "--ai") == 0) {
+            options.autoPlay = true;
+        } else if (std::strcmp(arg, "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (std::strcmp(arg, "--archive") == 0 && hasValue) {
+            options.archivePath = argv[++i];
+        } else if (std::strcmp(arg, "--stats") == 0 && hasValue) {
+            options.statsPath = argv[++i];
+        } else if (std::strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (std::strcmp(arg, "--headless") == 0) {
+            headless = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if ((headless && options.replayPath.empty()) || options.previewDepth < 1 ||
+        options.previewDepth > Renderer::MAX_PREVIEW_SHOWN) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    static const char* const BOARD_SIZES[] = {"10x20", "10x40", "16x20", "32x20"};
+    if (std::find(std::begin(BOARD_SIZES), std::end(BOARD_SIZES), boardSize) == std::end(BOARD_SIZES)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    // The autoplayer and the replay formats only know the standard board
+    bool standardBoard = boardSize == "10x20";
+    if (!standardBoard && (options.autoPlay || !options.recordPath.empty() || !options.archivePath.empty() ||
+                           !options.replayPath.empty())) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Replay replay;
+    if (!options.replayPath.empty()) {
+        std::string error;
+        if (!Replay::load(options.replayPath, replay, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        if (headless) {
+            return runHeadlessReplay(replay);
+        }
+    }
+
+#ifdef _WIN32
+    // Set console to UTF-8 mode for proper Unicode character rendering
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    if (standardBoard) {
+        return runSession<10, 20>(options, replay);
+    } else if (boardSize == "10x40") {
+        return runSession<10, 40>(options, replay);
+    } else if (boardSize == "16x20") {
+        return runSession<16, 20>(options, replay);
+    }
+    return runSession<32, 20>(options, replay);
+}
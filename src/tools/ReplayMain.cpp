@@ -0,0 +1,153 @@
+#include "../../include/Model/ReplayArchive.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " COMMAND ...\n"
+              << "  pack REPLAY ARCHIVE [--keyframe N]\n"
+              << "                   turn a replay into a seekable archive, with a keyframe\n"
+              << "                   every N pieces (default " << ReplayArchive::DEFAULT_KEYFRAME_INTERVAL << ")\n"
+              << "  info ARCHIVE     print what the archive holds\n"
+              << "  seek ARCHIVE (--piece N | --tick N)\n"
+              << "                   print the game right after piece N locked, or at tick N\n";
+}
+
+// Plays the replay from the menu as ReplayPlayer would, feeding every call
+// to the writer as it is made
+static int pack(const std::string& replayPath, const std::string& archivePath, int keyframeInterval) {
+    std::string error;
+    Replay replay;
+    if (!Replay::load(replayPath, replay, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    Game game(replay.seed);
+    game.setSeed(replay.seed);
+    game.setPiecePolicy(replay.piecePolicy);
+    ReplayArchiveWriter writer(game, keyframeInterval);
+    long long tick = 0;
+    for (const ReplayEvent& event : replay.events) {
+        Replay::advance(game, event.tick - tick);
+        writer.advance(event.tick - tick);
+        tick = event.tick;
+        game.applyAction(event.action);
+        writer.record(event.action);
+    }
+    Replay::advance(game, replay.summary.endTick - tick);
+    writer.advance(replay.summary.endTick - tick);
+
+    if (Replay::digest(game) != replay.summary.digest) {
+        std::cerr << "Error: " << replayPath << " does not play back as recorded" << std::endl;
+        return 1;
+    }
+    if (!writer.save(archivePath, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "events    " << writer.getEventCount() << "\n"
+              << "keyframes " << writer.getKeyframeCount() << "\n";
+    return 0;
+}
+
+static int info(const ReplayArchive& archive) {
+    const ReplaySummary& summary = archive.getSummary();
+    uint64_t compressed = 0;
+    uint64_t raw = 0;
+    for (const ReplayKeyframe& keyframe : archive.getKeyframes()) {
+        compressed += keyframe.compressedSize;
+        raw += keyframe.rawSize;
+    }
+    std::cout << "seed      " << archive.getSeed() << "\n"
+              << "generator " << PieceGenerator::getPolicyName(archive.getPiecePolicy()) << "\n"
+              << "events    " << archive.getEventCount() << "\n"
+              << "pieces    " << archive.getPieceCount() << "\n"
+              << "ticks     " << summary.endTick << "\n"
+              << "keyframes " << archive.getKeyframes().size() << " (every " << archive.getKeyframeInterval()
+              << " pieces)\n"
+              << "blocks    " << compressed << " bytes (" << raw << " uncompressed)\n"
+              << "score     " << summary.score << "\n"
+              << "lines     " << summary.linesCleared << "\n"
+              << "level     " << summary.level << "\n";
+    return 0;
+}
+
+static void printGame(const Game& game, long long tick) {
+    static const char* const STATE_NAMES[] = {"menu", "playing", "paused", "game over"};
+    std::cout << "tick      " << tick << "\n"
+              << "state     " << STATE_NAMES[static_cast<int>(game.getState())] << "\n"
+              << "score     " << game.getScore() << "\n"
+              << "lines     " << game.getLinesCleared() << "\n"
+              << "level     " << game.getLevel() << "\n"
+              << "pieces    " << game.getPiecesPlaced() << "\n"
+              << "current   " << game.getCurrentTetromino().getDisplayChar() << " at (" << game.getCurrentX() << ", "
+              << game.getCurrentY() << ")\n"
+              << "next      " << game.getNextTetromino().getDisplayChar() << "\n";
+    const Board& board = game.getBoard();
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        std::cout << "|";
+        for (uint8_t cell : board.getColorRow(y)) {
+            std::cout << (cell == 0 ? '.' : Tetromino(static_cast<TetrominoType>(cell - 1)).getDisplayChar());
+        }
+        std::cout << "|\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::string command = argv[1];
+
+    if (command == "pack") {
+        int keyframeInterval = ReplayArchive::DEFAULT_KEYFRAME_INTERVAL;
+        if (argc == 6 && std::strcmp(argv[4], "--keyframe") == 0) {
+            keyframeInterval = std::atoi(argv[5]);
+        } else if (argc != 4) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (keyframeInterval < 1) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return pack(argv[2], argv[3], keyframeInterval);
+    }
+
+    bool seekPiece = argc == 5 && std::strcmp(argv[3], "--piece") == 0;
+    bool seekTick = argc == 5 && std::strcmp(argv[3], "--tick") == 0;
+    if (!(command == "info" && argc == 3) && !(command == "seek" && (seekPiece || seekTick))) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string error;
+    ReplayArchive archive;
+    auto start = std::chrono::steady_clock::now();
+    if (!archive.open(argv[2], error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    if (command == "info") {
+        return info(archive);
+    }
+
+    Game game(0);
+    long long target = std::atoll(argv[4]);
+    long long tick = std::max(0LL, std::min(target, archive.getSummary().endTick));
+    bool found = seekPiece ? archive.seekToPiece(target, game, tick, error) : archive.seekToTick(tick, game, error);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!found) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    printGame(game, tick);
+    std::cout << std::fixed << std::setprecision(3) << "elapsed   " << elapsed.count() * 1000.0 << " ms\n";
+    return 0;
+}
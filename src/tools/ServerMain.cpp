@@ -0,0 +1,159 @@
+#include "../../include/Server/GameServer.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static GameServer* activeServer = nullptr;
+
+static void handleSignal(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --port N           TCP port, 0 = any free one (default 7777)\n"
+              << "  --host ADDR        IPv4 address to listen on (default 127.0.0.1)\n"
+              << "  --unix PATH        listen on a unix socket instead of TCP\n"
+              << "  --max-sessions N   refuse connections beyond N (default 10000)\n"
+              << "  --pieces NAME      piece generator: uniform, 7-bag or 14-bag (default uniform)\n"
+              << "  --preview N        upcoming pieces to show, 1-" << Renderer::MAX_PREVIEW_SHOWN << " (default 1)\n"
+              << "  --raw              clients send raw key bytes; skip telnet negotiation\n"
+              << "  --spectate-port N  accept spectators on TCP port N (default off)\n"
+              << "  --spectate-unix PATH accept spectators on a unix socket\n"
+              << "  --max-spectators N refuse spectators beyond N (default 10000)\n"
+              << "  --report N         print load, memory and latency every N seconds (default 10, 0 = off)\n"
+              << "Connect with e.g. `telnet 127.0.0.1 7777`. Spectators use Left/Right to\n"
+              << "switch between games.\n";
+}
+
+// Counters as of the previous report, so each line shows rates since then
+struct ReportBaseline {
+    GameServer::Clock::time_point time = GameServer::Clock::now();
+    uint64_t busyNanos = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t broadcastFrames = 0;
+    uint64_t framesQueued = 0;
+};
+
+static void printReport(const GameServer& server, ReportBaseline& baseline, const char* label) {
+    const ServerStats& stats = server.getStats();
+    auto time = GameServer::Clock::now();
+    double seconds = std::chrono::duration<double>(time - baseline.time).count();
+    if (seconds <= 0.0) seconds = 1e-9;
+    size_t memory = server.getSessionMemoryBytes();
+    const Histogram& latency = stats.keyLatencyNanos;
+
+    std::fprintf(stderr,
+                 "%s: sessions %zu (peak %zu, accepted %llu, refused %llu)  mem/session %.1f KB"
+                 "  key->sent p50 %.1f us p99 %.1f us max %.1f us  loop busy %.1f%%"
+                 "  in %.1f KB/s out %.1f KB/s\n",
+                 label, stats.sessions, stats.peakSessions,
+                 static_cast<unsigned long long>(stats.accepted),
+                 static_cast<unsigned long long>(stats.rejected),
+                 stats.sessions > 0 ? static_cast<double>(memory) / static_cast<double>(stats.sessions) / 1024.0 : 0.0,
+                 static_cast<double>(latency.getPercentile(50.0)) / 1e3,
+                 static_cast<double>(latency.getPercentile(99.0)) / 1e3,
+                 static_cast<double>(latency.getMax()) / 1e3,
+                 static_cast<double>(stats.busyNanos - baseline.busyNanos) / (seconds * 1e9) * 100.0,
+                 static_cast<double>(stats.bytesIn - baseline.bytesIn) / seconds / 1024.0,
+                 static_cast<double>(stats.bytesOut - baseline.bytesOut) / seconds / 1024.0);
+    if (stats.peakSpectators > 0) {
+        uint64_t frames = stats.broadcastFrames - baseline.broadcastFrames;
+        size_t spectatorMemory = server.getSpectatorMemoryBytes();
+        std::fprintf(stderr,
+                     "  spectators %zu (peak %zu, accepted %llu, refused %llu)  mem/spectator %.2f KB"
+                     "  frames %.1f/s (keyframes %llu total)  fan-out %.1f  dropped %llu total\n",
+                     stats.spectators, stats.peakSpectators,
+                     static_cast<unsigned long long>(stats.spectatorsAccepted),
+                     static_cast<unsigned long long>(stats.spectatorsRejected),
+                     stats.spectators > 0 ? static_cast<double>(spectatorMemory) / static_cast<double>(stats.spectators) / 1024.0 : 0.0,
+                     static_cast<double>(frames) / seconds,
+                     static_cast<unsigned long long>(stats.keyframes),
+                     frames > 0 ? static_cast<double>(stats.framesQueued - baseline.framesQueued) / static_cast<double>(frames) : 0.0,
+                     static_cast<unsigned long long>(stats.framesDropped));
+    }
+
+    baseline.time = time;
+    baseline.busyNanos = stats.busyNanos;
+    baseline.bytesIn = stats.bytesIn;
+    baseline.bytesOut = stats.bytesOut;
+    baseline.broadcastFrames = stats.broadcastFrames;
+    baseline.framesQueued = stats.framesQueued;
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    int reportSeconds = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--port") == 0 && hasValue) {
+            config.port = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--host") == 0 && hasValue) {
+            config.host = argv[++i];
+        } else if (std::strcmp(arg, "--unix") == 0 && hasValue) {
+            config.unixPath = argv[++i];
+        } else if (std::strcmp(arg, "--max-sessions") == 0 && hasValue) {
+            config.maxSessions = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--pieces") == 0 && hasValue) {
+            if (!PieceGenerator::parsePolicy(argv[++i], config.session.piecePolicy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--preview") == 0 && hasValue) {
+            config.session.previewDepth = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--raw") == 0) {
+            config.session.telnet = false;
+        } else if (std::strcmp(arg, "--spectate-port") == 0 && hasValue) {
+            config.spectatePort = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--spectate-unix") == 0 && hasValue) {
+            config.spectateUnixPath = argv[++i];
+        } else if (std::strcmp(arg, "--max-spectators") == 0 && hasValue) {
+            config.maxSpectators = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--report") == 0 && hasValue) {
+            reportSeconds = std::atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.port < 0 || config.port > 65535 || config.spectatePort > 65535 || reportSeconds < 0 ||
+        config.session.previewDepth < 1 || config.session.previewDepth > Renderer::MAX_PREVIEW_SHOWN) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    GameServer server(config);
+    std::string error;
+    if (!server.listen(error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    activeServer = &server;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cerr << "listening on " << server.getAddress() << "\n";
+    if (!server.getSpectateAddress().empty()) {
+        std::cerr << "spectators on " << server.getSpectateAddress() << "\n";
+    }
+
+    ReportBaseline baseline;
+    bool ok = server.run(error, reportSeconds * 1000,
+                         [&](const GameServer& running) { printReport(running, baseline, "report"); });
+    activeServer = nullptr;
+    printReport(server, baseline, "exit");
+    if (!ok) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "../../include/Sim/BatchRunner.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --games N        number of games to play (default 1000)\n"
+              << "  --threads N      worker threads, 0 = all cores (default 0)\n"
+              << "  --seed N         base seed (default 1)\n"
+              << "  --policy NAME    input policy (default random-placement)\n"
+              << "  --ticks N        gravity ticks between inputs, >= 1 (default 16)\n"
+              << "  --max-pieces N   stop a game after N pieces (default 100000)\n"
+              << "  --pieces NAME    piece generator: uniform, 7-bag or 14-bag (default uniform)\n"
+              << "  --table-mb N     share an N MB transposition table between ai searches (default 0, off)\n"
+              << "Policies:";
+    for (const auto& name : Policy::getNames()) {
+        std::cerr << " " << name;
+    }
+    std::cerr << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    std::string policyName = "random-placement";
+    size_t tableMegabytes = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--games") == 0 && hasValue) {
+            config.games = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--policy") == 0 && hasValue) {
+            policyName = argv[++i];
+        } else if (std::strcmp(arg, "--ticks") == 0 && hasValue) {
+            config.ticksPerAction = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--max-pieces") == 0 && hasValue) {
+            config.maxPieces = std::atoll(argv[++i]);
+        } else if (std::strcmp(arg, "--pieces") == 0 && hasValue) {
+            if (!PieceGenerator::parsePolicy(argv[++i], config.piecePolicy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--table-mb") == 0 && hasValue) {
+            tableMegabytes = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::unique_ptr<Policy> policy = Policy::create(policyName);
+    if (!policy || config.ticksPerAction < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::unique_ptr<TranspositionTable> table;
+    if (tableMegabytes > 0) {
+        auto* ai = dynamic_cast<AiPolicy*>(policy.get());
+        if (!ai) {
+            std::cerr << "--table-mb needs an ai policy\n";
+            return 1;
+        }
+        table = std::make_unique<TranspositionTable>(tableMegabytes);
+        ai->setTranspositionTable(table.get());
+    }
+
+    BatchRunner runner(config, *policy);
+    SimStats stats = runner.run();
+
+    double seconds = stats.elapsedSeconds > 0.0 ? stats.elapsedSeconds : 1e-9;
+    double games = stats.games > 0 ? static_cast<double>(stats.games) : 1.0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "policy        " << policy->getName() << "\n";
+    std::cout << "pieces        " << PieceGenerator::getPolicyName(config.piecePolicy) << "\n";
+    std::cout << "games         " << stats.games << "\n";
+    std::cout << "threads       " << stats.threads << "\n";
+    std::cout << "elapsed       " << seconds << " s\n";
+    std::cout << "games/sec     " << stats.games / seconds << "\n";
+    std::cout << "pieces/sec    " << stats.pieces / seconds << "\n";
+    std::cout << "actions/sec   " << stats.actions / seconds << "\n";
+    std::cout << "score         mean " << stats.getMeanScore()
+              << "  stddev " << stats.getScoreStdDev()
+              << "  min " << stats.minScore
+              << "  max " << stats.maxScore << "\n";
+    std::cout << "lines         mean " << stats.lines / games
+              << "  max " << stats.maxLines << "\n";
+    std::cout << "pieces/game   " << stats.pieces / games << "\n";
+    std::cout << "max level     " << stats.maxLevel << "\n";
+
+    if (table) {
+        TableStats tableStats = table->getStats();
+        double probes = tableStats.probes > 0 ? static_cast<double>(tableStats.probes) : 1.0;
+        std::cout << "table         " << table->getSizeBytes() / (1024.0 * 1024.0) << " MB"
+                  << "  " << table->getBucketCount() << " buckets\n";
+        std::cout << "table probes  " << tableStats.probes
+                  << "  hit rate " << 100.0 * tableStats.hits / probes << "%"
+                  << "  collisions " << 100.0 * tableStats.collisions / probes << "%\n";
+        std::cout << "table stores  " << tableStats.stores
+                  << "  replacements " << tableStats.replacements << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "../../include/Sim/ReplayVerifier.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] PATH...\n"
+              << "  Plays back every replay and replay archive in each directory PATH (or\n"
+              << "  the file PATH) and accepts it only if it ends with the recorded score,\n"
+              << "  level, lines and final state. Exits with 1 if anything was rejected.\n"
+              << "  --threads N      worker threads, 0 = all cores (default 0)\n"
+              << "  --rejects-only   leave accepted files out of the listing\n";
+}
+
+// The files to check, in name order within each directory
+static bool collectPaths(const std::string& path, std::vector<std::string>& paths) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error)) {
+        paths.push_back(path);
+        return true;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+        if (entry.is_regular_file(error)) {
+            found.push_back(entry.path().string());
+        }
+    }
+    if (error) {
+        std::cerr << "Error: cannot list " << path << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::sort(found.begin(), found.end());
+    paths.insert(paths.end(), found.begin(), found.end());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = 0;
+    bool rejectsOnly = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--rejects-only") == 0) {
+            rejectsOnly = true;
+        } else if (arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (!collectPaths(arg, paths)) {
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ReplayVerifier verifier(threads);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ReplayVerdict> verdicts = verifier.verify(paths);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds <= 0.0) seconds = 1e-9;
+
+    size_t accepted = 0;
+    long long events = 0;
+    for (const ReplayVerdict& verdict : verdicts) {
+        events += verdict.events;
+        if (verdict.accepted) {
+            ++accepted;
+            if (!rejectsOnly) {
+                std::cout << "accept  " << verdict.path << "  score " << verdict.score << "  level " << verdict.level
+                          << "  lines " << verdict.linesCleared << "\n";
+            }
+        } else {
+            std::cout << "reject  " << verdict.path << "  " << verdict.reason << "\n";
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "files         " << verdicts.size() << "\n";
+    std::cout << "accepted      " << accepted << "\n";
+    std::cout << "rejected      " << verdicts.size() - accepted << "\n";
+    std::cout << "threads       " << verifier.getThreadCount() << "\n";
+    std::cout << "elapsed       " << seconds << " s\n";
+    std::cout << "files/sec     " << verdicts.size() / seconds << "\n";
+    std::cout << "events/sec    " << events / seconds << "\n";
+    return accepted == verdicts.size() ? 0 : 1;
+}